@@ -0,0 +1,220 @@
+#ifndef UNITS_CALCULUS_H
+#define UNITS_CALCULUS_H
+
+#include "quantities.h"
+#include "unit.h"
+
+#include <limits>
+#include <stdexcept>
+#include <span>
+#include <vector>
+
+namespace units
+{
+    /// <summary>
+    /// Cumulative trapezoid integration of a series against time, e.g. Velocity into Length or Power into Energy.
+    /// Samples can be fed in chunks; the last sample and the running total carry over between calls.
+    /// The result is in the standard unit of MultiplyType&lt;Q, quantities::Time&gt;.
+    /// values, times and out must be the same size, or process throws std::invalid_argument.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, typename TimeConversion = NoConversion>
+    class Integrator
+    {
+    public:
+        using Input = Unit<N, Q, C>;
+        using TimePoint = Unit<N, quantities::Time, TimeConversion>;
+        using Output = Unit<N, MultiplyType<Q, quantities::Time>, NoConversion>;
+
+        constexpr Integrator() = default;
+        explicit constexpr Integrator(const Output& start) : m_total{ start.value() } {}
+
+        //writes the running integral at each sample into out, which must be as long as values and times
+        void process(std::span<const Input> values, std::span<const TimePoint> times, std::span<Output> out);
+
+        constexpr Output total()const { return Output(m_total); }
+
+    private:
+        bool m_started = false;
+        N m_lastValue{};
+        N m_lastTime{};
+        N m_total{};
+    };
+
+    /// <summary>
+    /// Backward finite differences of a series against time, e.g. Length into Velocity or Velocity into Acceleration.
+    /// Samples can be fed in chunks; the last sample carries over between calls. The first sample of a stream
+    /// has nothing before it, so its derivative is NaN. The result is in the standard unit of DivideType&lt;Q, quantities::Time&gt;.
+    /// values, times and out must be the same size, or process throws std::invalid_argument.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, typename TimeConversion = NoConversion>
+    class Differentiator
+    {
+    public:
+        using Input = Unit<N, Q, C>;
+        using TimePoint = Unit<N, quantities::Time, TimeConversion>;
+        using Output = Unit<N, DivideType<Q, quantities::Time>, NoConversion>;
+
+        //writes the derivative at each sample into out, which must be as long as values and times
+        void process(std::span<const Input> values, std::span<const TimePoint> times, std::span<Output> out);
+
+    private:
+        bool m_started = false;
+        N m_lastValue{};
+        N m_lastTime{};
+    };
+
+    /// <summary>
+    /// Linear resampling of a series onto a uniform time grid. Samples can be fed in chunks; the last sample
+    /// and the next grid time carry over between calls. Interpolation happens in the input's own unit,
+    /// so the output has the same type as the input and needs no conversion.
+    /// values and times must be the same size, or process throws std::invalid_argument.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, typename TimeConversion = NoConversion>
+    class Resampler
+    {
+    public:
+        using Input = Unit<N, Q, C>;
+        using TimePoint = Unit<N, quantities::Time, TimeConversion>;
+
+        constexpr Resampler(const TimePoint& start, const TimePoint& period) : m_next{ start.value() }, m_period{ period.value() } {}
+
+        //appends a sample to out for each grid time covered by the samples seen so far, returning how many were added
+        size_t process(std::span<const Input> values, std::span<const TimePoint> times, std::vector<Input>& out);
+
+    private:
+        bool m_started = false;
+        N m_lastValue{};
+        N m_lastTime{};
+        N m_next;
+        N m_period;
+    };
+
+    template<typename N, typename Q, typename C, typename TC>
+    void Integrator<N, Q, C, TC>::process(std::span<const Input> values, std::span<const TimePoint> times, std::span<Output> out)
+    {
+        if (times.size() != values.size() || out.size() != values.size()) throw std::invalid_argument("values, times and out must be the same size");
+        const size_t n = values.size();
+        if (n == 0) return;
+
+        //0.5 * (g * (v0 + v1) + 2i) * kt * dt, with the conversions folded into two constants for the whole chunk
+        const N kt = affine<TC, NoConversion, N>().scale;
+        const Affine<N> f = affine<C, NoConversion, N>();
+        const N a = N(0.5) * f.scale * kt;
+        const N b = f.offset * kt;
+
+        size_t first = 0;
+        if (!m_started)
+        {
+            m_started = true;
+            m_lastValue = values[0].value();
+            m_lastTime = times[0].value();
+            out[0] = Output(m_total);
+            first = 1;
+        }
+
+        //increments are independent of each other, so this loop vectorises; only the running sum below is sequential
+        if (first < n)
+        {
+            out[first] = Output((a * (values[first].value() + m_lastValue) + b) * (times[first].value() - m_lastTime));
+        }
+        for (size_t i = first + 1; i < n; ++i)
+        {
+            out[i] = Output((a * (values[i].value() + values[i - 1].value()) + b) * (times[i].value() - times[i - 1].value()));
+        }
+
+        N total = m_total;
+        for (size_t i = first; i < n; ++i)
+        {
+            total += out[i].value();
+            out[i] = Output(total);
+        }
+
+        m_total = total;
+        m_lastValue = values[n - 1].value();
+        m_lastTime = times[n - 1].value();
+    }
+
+    template<typename N, typename Q, typename C, typename TC>
+    void Differentiator<N, Q, C, TC>::process(std::span<const Input> values, std::span<const TimePoint> times, std::span<Output> out)
+    {
+        if (times.size() != values.size() || out.size() != values.size()) throw std::invalid_argument("values, times and out must be the same size");
+        const size_t n = values.size();
+        if (n == 0) return;
+
+        const N k = affine<C, NoConversion, N>().scale / affine<TC, NoConversion, N>().scale;
+
+        if (!m_started)
+        {
+            if constexpr (std::numeric_limits<N>::has_quiet_NaN) out[0] = Output(std::numeric_limits<N>::quiet_NaN());
+            else out[0] = Output(N{});
+        }
+        else
+        {
+            out[0] = Output(k * (values[0].value() - m_lastValue) / (times[0].value() - m_lastTime));
+        }
+
+        for (size_t i = 1; i < n; ++i)
+        {
+            out[i] = Output(k * (values[i].value() - values[i - 1].value()) / (times[i].value() - times[i - 1].value()));
+        }
+
+        m_started = true;
+        m_lastValue = values[n - 1].value();
+        m_lastTime = times[n - 1].value();
+    }
+
+    template<typename N, typename Q, typename C, typename TC>
+    size_t Resampler<N, Q, C, TC>::process(std::span<const Input> values, std::span<const TimePoint> times, std::vector<Input>& out)
+    {
+        if (times.size() != values.size()) throw std::invalid_argument("values and times must be the same size");
+        const size_t n = values.size();
+        const size_t before = out.size();
+        if (n == 0) return 0;
+
+        size_t i = 0;
+        if (!m_started)
+        {
+            m_started = true;
+            m_lastValue = values[0].value();
+            m_lastTime = times[0].value();
+            i = 1;
+        }
+
+        for (; i < n; ++i)
+        {
+            const N t0 = i == 0 ? m_lastTime : times[i - 1].value();
+            const N v0 = i == 0 ? m_lastValue : values[i - 1].value();
+            const N t1 = times[i].value();
+            const N v1 = values[i].value();
+            const N slope = (v1 - v0) / (t1 - t0);
+            for (; m_next <= t1; m_next += m_period)
+            {
+                if (m_next >= t0) out.emplace_back(v0 + slope * (m_next - t0));
+            }
+        }
+
+        m_lastValue = values[n - 1].value();
+        m_lastTime = times[n - 1].value();
+        return out.size() - before;
+    }
+
+    //integrates a whole series at once
+    template<typename N, typename Q, typename C, typename TC>
+    std::vector<typename Integrator<N, Q, C, TC>::Output> integrate(const std::vector<Unit<N, Q, C>>& values, const std::vector<Unit<N, quantities::Time, TC>>& times)
+    {
+        std::vector<typename Integrator<N, Q, C, TC>::Output> out(values.size());
+        Integrator<N, Q, C, TC>{}.process(values, times, out);
+        return out;
+    }
+
+    //differentiates a whole series at once
+    template<typename N, typename Q, typename C, typename TC>
+    std::vector<typename Differentiator<N, Q, C, TC>::Output> differentiate(const std::vector<Unit<N, Q, C>>& values, const std::vector<Unit<N, quantities::Time, TC>>& times)
+    {
+        std::vector<typename Differentiator<N, Q, C, TC>::Output> out(values.size());
+        Differentiator<N, Q, C, TC>{}.process(values, times, out);
+        return out;
+    }
+}
+
+#endif
@@ -0,0 +1,179 @@
+# Compares the disassembly of each unit_<name> kernel in an object file against raw_<name>.
+# usage: cmake -DOBJDUMP=<objdump> -DOBJECTS=<object files> [-DTOLERANCE=<instructions>] [-DTOLERANCE_<name>=<instructions>] -P codegen.cmake
+# addresses, symbol names and padding are stripped, and every constant an instruction loads through a relocation is
+# replaced by its bytes, so a wrong conversion factor differs even though its address doesn't. a pair fails when more
+# than TOLERANCE_<name> (or TOLERANCE) instructions must be inserted, removed or changed to turn one into the other.
+
+cmake_minimum_required(VERSION 3.18)
+
+if(NOT DEFINED TOLERANCE)
+	set(TOLERANCE 0)
+endif()
+
+# the number of instructions to insert, remove or change to turn list a into list b
+function(edit_distance a b out)
+	list(LENGTH ${a} n)
+	list(LENGTH ${b} m)
+	if(n EQUAL 0 OR m EQUAL 0)
+		math(EXPR distance "${n} + ${m}")
+		set(${out} ${distance} PARENT_SCOPE)
+		return()
+	endif()
+	set(previous)
+	foreach(j RANGE ${m})
+		list(APPEND previous ${j})
+	endforeach()
+	foreach(i RANGE 1 ${n})
+		math(EXPR ai "${i} - 1")
+		list(GET ${a} ${ai} x)
+		set(row ${i})
+		set(left ${i})
+		foreach(j RANGE 1 ${m})
+			math(EXPR bj "${j} - 1")
+			list(GET ${b} ${bj} y)
+			list(GET previous ${bj} diagonal)
+			list(GET previous ${j} up)
+			if(x STREQUAL y)
+				set(cell ${diagonal})
+			else()
+				set(cell ${diagonal})
+				if(up LESS cell)
+					set(cell ${up})
+				endif()
+				if(left LESS cell)
+					set(cell ${left})
+				endif()
+				math(EXPR cell "${cell} + 1")
+			endif()
+			list(APPEND row ${cell})
+			set(left ${cell})
+		endforeach()
+		set(previous ${row})
+	endforeach()
+	set(${out} ${left} PARENT_SCOPE)
+endfunction()
+
+set(failures 0)
+set(pairs 0)
+foreach(object IN LISTS OBJECTS)
+	execute_process(COMMAND ${OBJDUMP} -dr --no-show-raw-insn ${object}
+		OUTPUT_VARIABLE disassembly
+		RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${OBJDUMP} failed on ${object}")
+	endif()
+	execute_process(COMMAND ${OBJDUMP} -t ${object} OUTPUT_VARIABLE symbols)
+	execute_process(COMMAND ${OBJDUMP} -s ${object} OUTPUT_VARIABLE contents)
+
+	# the contents of every section as one hex string, and where each symbol is in them
+	set(sections)
+	string(REPLACE ";" "," contents "${contents}")
+	string(REPLACE "\n" ";" lines "${contents}")
+	set(section)
+	foreach(line IN LISTS lines)
+		if(line MATCHES "^Contents of section ([^:]+):$")
+			set(section ${CMAKE_MATCH_1})
+			list(APPEND sections ${section})
+			set(bytes_${section})
+		elseif(section AND line MATCHES "^ [0-9a-f]+ (([0-9a-f]+ )+)")
+			string(REPLACE " " "" hex "${CMAKE_MATCH_1}")
+			string(APPEND bytes_${section} "${hex}")
+		endif()
+	endforeach()
+	foreach(section IN LISTS sections)
+		set(section_${section} ${section})
+		set(offset_${section} 0)
+	endforeach()
+	string(REPLACE ";" "," symbols "${symbols}")
+	string(REPLACE "\n" ";" lines "${symbols}")
+	foreach(line IN LISTS lines)
+		if(line MATCHES "^([0-9a-f]+) [^\t]* ([^ \t]+)\t[0-9a-f]+ (.+)$" AND CMAKE_MATCH_2 IN_LIST sections)
+			set(section_${CMAKE_MATCH_3} ${CMAKE_MATCH_2})
+			math(EXPR offset_${CMAKE_MATCH_3} "0x${CMAKE_MATCH_1}" OUTPUT_FORMAT DECIMAL)
+		endif()
+	endforeach()
+
+	# split into one list of normalised instructions per function
+	string(REPLACE ";" "," disassembly "${disassembly}")
+	string(REPLACE "[" "(" disassembly "${disassembly}")
+	string(REPLACE "]" ")" disassembly "${disassembly}")
+	string(REPLACE "\n" ";" lines "${disassembly}")
+	set(functions)
+	set(current)
+	foreach(line IN LISTS lines)
+		if(line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_]+)>:$")
+			set(current ${CMAKE_MATCH_1})
+			list(APPEND functions ${current})
+			set(body_${current})
+		elseif(current AND line MATCHES "^\t+[0-9a-f]+: (R_[A-Z0-9_]+)\t([^+-]+)([+-]0x[0-9a-f]+)?$")
+			# a relocation of the instruction before it: a constant is replaced by its bytes, anything else by its symbol
+			set(type ${CMAKE_MATCH_1})
+			set(target ${CMAKE_MATCH_2})
+			set(addend 0)
+			if(CMAKE_MATCH_3)
+				math(EXPR addend "${CMAKE_MATCH_3}" OUTPUT_FORMAT DECIMAL)
+			endif()
+			list(POP_BACK body_${current} instruction)
+			if(DEFINED section_${target} AND section_${target} MATCHES "^\\.rodata")
+				set(section ${section_${target}})
+				# an x86-64 PC-relative addend is taken from the end of the 4 byte displacement
+				if(type MATCHES "PC32$")
+					math(EXPR addend "${addend} + 4")
+				endif()
+				set(width 8)
+				if(section MATCHES "\\.cst([0-9]+)$")
+					set(width ${CMAKE_MATCH_1})
+				endif()
+				math(EXPR start "(${offset_${target}} + ${addend}) * 2")
+				math(EXPR width "${width} * 2")
+				string(SUBSTRING "${bytes_${section}}" ${start} ${width} constant)
+				list(APPEND body_${current} "${instruction} =0x${constant}")
+			else()
+				list(APPEND body_${current} "${instruction} ${target}")
+			endif()
+		elseif(current AND line MATCHES "^ *[0-9a-f]+:\t(.*)$")
+			set(instruction "${CMAKE_MATCH_1}")
+			string(REGEX REPLACE " *#.*$" "" instruction "${instruction}")
+			string(REGEX REPLACE "[0-9a-f]+ <[A-Za-z0-9_]+(\\+0x[0-9a-f]+)?>" "<\\1>" instruction "${instruction}")
+			string(REGEX REPLACE "[ \t]+" " " instruction "${instruction}")
+			if(NOT instruction MATCHES "(^| )nop[wlq]?( |$)" AND NOT instruction STREQUAL "xchg %ax,%ax")
+				list(APPEND body_${current} "${instruction}")
+			endif()
+		endif()
+	endforeach()
+
+	foreach(function IN LISTS functions)
+		if(NOT function MATCHES "^unit_(.*)$")
+			continue()
+		endif()
+		set(name ${CMAKE_MATCH_1})
+		set(raw raw_${name})
+		math(EXPR pairs "${pairs} + 1")
+		if(NOT raw IN_LIST functions)
+			message(SEND_ERROR "${function} has no ${raw} to compare against")
+			math(EXPR failures "${failures} + 1")
+			continue()
+		endif()
+
+		set(tolerance ${TOLERANCE})
+		if(DEFINED TOLERANCE_${name})
+			set(tolerance ${TOLERANCE_${name}})
+		endif()
+		edit_distance(body_${function} body_${raw} differences)
+		if(differences GREATER tolerance)
+			string(REPLACE ";" "\n  " unitListing "${body_${function}}")
+			string(REPLACE ";" "\n  " rawListing "${body_${raw}}")
+			message(SEND_ERROR "${function} differs from ${raw} by ${differences} instructions\n"
+				"${function}:\n  ${unitListing}\n${raw}:\n  ${rawListing}")
+			math(EXPR failures "${failures} + 1")
+		endif()
+	endforeach()
+endforeach()
+
+if(pairs EQUAL 0)
+	message(FATAL_ERROR "no unit_ kernels found in ${OBJECTS}")
+endif()
+message(STATUS "${pairs} kernel pairs compared, ${failures} differ")
+if(failures GREATER 0)
+	message(FATAL_ERROR "Unit does not compile to the same code as raw scalars")
+endif()
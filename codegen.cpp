@@ -0,0 +1,70 @@
+// Paired kernels for the codegen-equivalence tests: each unit_<name> must compile to the same instructions as raw_<name>,
+// the same computation written on plain doubles. Conversions are written out in the raw kernels exactly as the
+// conversion structs evaluate them, so that both sides describe the same floating point operations.
+#include "units.h"
+
+using Metres = units::metres<double>;
+using Kilometres = units::kilometres<double>;
+using Millimetres = units::millimetres<double>;
+using Seconds = units::seconds<double>;
+
+extern "C"
+{
+    double unit_add(Metres a, Metres b) { return (a + b).value(); }
+    double raw_add(double a, double b) { return a + b; }
+
+    double unit_add_scaled(Kilometres a, Kilometres b) { return (a + b).value(); }
+    double raw_add_scaled(double a, double b) { return a + b; }
+
+    double unit_subtract(Metres a, Metres b) { return (a - b).value(); }
+    double raw_subtract(double a, double b) { return a - b; }
+
+    double unit_scale(Metres a, double s) { return (a * s).value(); }
+    double raw_scale(double a, double s) { return a * s; }
+
+    double unit_scale_left(double s, Metres a) { return (s * a).value(); }
+    double raw_scale_left(double s, double a) { return s * a; }
+
+    double unit_divide(Metres a, double s) { return (a / s).value(); }
+    double raw_divide(double a, double s) { return a / s; }
+
+    double unit_multiply(Metres a, Seconds b) { return (a * b).value(); }
+    double raw_multiply(double a, double b) { return a * b; }
+
+    double unit_add_assign(Kilometres a, Millimetres b) { a += b; return a.value(); }
+    double raw_add_assign(double a, double b) { a += (0.001 * b) / 1000.0; return a; }
+
+    double unit_subtract_assign(Metres a, Metres b) { a -= b; return a.value(); }
+    double raw_subtract_assign(double a, double b) { a -= b; return a; }
+
+    double unit_to_unit(Kilometres a) { return a.toUnit<units::conversions::milli>().value(); }
+    double raw_to_unit(double a) { return (1000.0 * a) / 0.001; }
+
+    double unit_ratio(Metres a, Metres b) { return a / b; }
+    double raw_ratio(double a, double b) { return a / b; }
+
+    double unit_ratio_scaled(Kilometres a, Millimetres b) { return a / b; }
+    double raw_ratio_scaled(double a, double b) { return (1000.0 / 0.001) * (a / b); }
+
+    double unit_sum(const Metres* p, long n)
+    {
+        Metres total;
+        for (long i = 0; i < n; ++i) total += p[i];
+        return total.value();
+    }
+    double raw_sum(const double* p, long n)
+    {
+        double total{};
+        for (long i = 0; i < n; ++i) total += p[i];
+        return total;
+    }
+
+    void unit_axpy(Metres* y, const Metres* x, double a, long n)
+    {
+        for (long i = 0; i < n; ++i) y[i] += a * x[i];
+    }
+    void raw_axpy(double* y, const double* x, double a, long n)
+    {
+        for (long i = 0; i < n; ++i) y[i] += a * x[i];
+    }
+}
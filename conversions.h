@@ -27,8 +27,18 @@ namespace units
         }
     };
     
+    //a struct which can convert a NumericType to and from the standard unit
+    template<typename Impl, typename NumericType = double>
+    concept ConversionPolicy = requires(const NumericType& x)
+    {
+        Impl::unitToStandard(x);
+        Impl::standardToUnit(x);
+    };
+
     struct NoConversion
     {
+        static constexpr char conversion_name[] = "NoConversion";
+
         template<typename NumericType>
         static constexpr NumericType unitToStandard(const NumericType& unitValue)noexcept
         {
@@ -40,31 +50,56 @@ namespace units
         {
             return standardValue;
         }
+
+        using DeltaConversion = NoConversion;
     };
 
 #define CREATE_RATIO_CONVERSION(name, ratio)\
 struct name\
 {\
+static constexpr char conversion_name[] = #name;\
+\
 template<typename NumericType>\
 static constexpr NumericType unitToStandard(const NumericType& unitValue)noexcept{ return (ratio) * unitValue;}\
 \
 template<typename NumericType>\
 static constexpr NumericType standardToUnit(const NumericType& unitValue)noexcept { return unitValue/(ratio); }\
+\
+using DeltaConversion = name;\
 };
 
 #define CREATE_LINEAR_CONVERSION(name, intercept, gradient)\
 struct name\
 {\
+    static constexpr char conversion_name[] = #name;\
+    \
     template<typename NumericType>\
     static constexpr NumericType unitToStandard(const NumericType& unitValue)noexcept { return (gradient)*unitValue + (intercept); }\
     \
     template<typename NumericType>\
     static constexpr NumericType standardToUnit(const NumericType& unitValue)noexcept { return (unitValue  - (intercept))/(gradient); }\
+    \
+    struct Delta\
+    {\
+        static constexpr char conversion_name[] = #name "Delta";\
+        \
+        template<typename NumericType>\
+        static constexpr NumericType unitToStandard(const NumericType& unitValue)noexcept { return (gradient)*unitValue; }\
+        \
+        template<typename NumericType>\
+        static constexpr NumericType standardToUnit(const NumericType& unitValue)noexcept { return unitValue/(gradient); }\
+        \
+        using DeltaConversion = Delta;\
+        using PointConversion = name;\
+    };\
+    using DeltaConversion = Delta;\
 };
 
 #define CREATE_LOGARITHMIC_CONVERSION(name, base, multiplier)\
 struct name\
 {\
+    static constexpr char conversion_name[] = #name;\
+    \
     template<typename NumericType>\
     static NumericType unitToStandard(const NumericType& unitValue)noexcept { return (multiplier) * log(unitValue/log((base))); }\
     \
@@ -87,7 +122,61 @@ struct name\
         CREATE_RATIO_CONVERSION(nano, 1e-9);
 
         CREATE_LOGARITHMIC_CONVERSION(decibel, 10.0, 10.0);
+
+        CREATE_LINEAR_CONVERSION(celsius, 273.15, 1.0);
+        CREATE_LINEAR_CONVERSION(fahrenheit, 459.67 * 5.0 / 9.0, 5.0 / 9.0);
+    }
+
+    //a conversion made of a gradient and (optionally) an intercept. the ratio and linear conversion macros produce these.
+    //DeltaConversion is the conversion for differences between values in the unit, i.e. the gradient alone
+    template<typename Impl>
+    concept LinearConversion = requires { typename Impl::DeltaConversion; };
+
+    template<LinearConversion Impl>
+    using DeltaOf = typename Impl::DeltaConversion;
+
+    //the scale and offset of a linear map, e.g. from values in one linear conversion to the same values in another
+    template<typename N>
+    struct Affine
+    {
+        N scale = N(1);
+        N offset = N(0);
+
+        constexpr N operator()(N x)const noexcept { return scale * x + offset; }
+    };
+
+    //takes a value in From to the same value in To. affine<C, NoConversion, N>() is C's gradient and intercept, and
+    //between two ratio conversions the offset is 0 and the scale is their ratio
+    template<LinearConversion From, LinearConversion To, typename N>
+    constexpr Affine<N> affine()noexcept
+    {
+        const N offset = To::standardToUnit(From::unitToStandard(N(0)));
+        return { To::standardToUnit(From::unitToStandard(N(1))) - offset, offset };
     }
+
+    //a conversion with no intercept, for which differences and values are converted the same way
+    template<typename Impl>
+    constexpr bool b_is_delta_conversion = false;
+
+    template<LinearConversion Impl>
+    constexpr bool b_is_delta_conversion<Impl> = b_is_same<Impl, DeltaOf<Impl>>;
+
+    //a conversion with an intercept (an affine point, like Celsius), whose differences are in its DeltaConversion
+    template<typename Impl>
+    constexpr bool b_is_point_conversion = false;
+
+    template<LinearConversion Impl>
+    constexpr bool b_is_point_conversion<Impl> = !b_is_same<Impl, DeltaOf<Impl>>;
+
+    //the DeltaConversion of a point conversion, like Celsius' Delta. only these are differences against a point:
+    //a plain ratio conversion of the same quantity (like kelvins) is a value in its own right
+    template<typename Impl>
+    constexpr bool b_is_point_delta = requires { typename Impl::PointConversion; };
+
+    //a point and a difference between points, which mean different things and so don't convert into each other
+    template<typename Conversion1, typename Conversion2>
+    constexpr bool b_is_point_and_delta = (b_is_point_conversion<Conversion1> && b_is_point_delta<Conversion2>)
+        || (b_is_point_delta<Conversion1> && b_is_point_conversion<Conversion2>);
 }
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,649 @@
+#ifndef UNITS_INGEST_H
+#define UNITS_INGEST_H
+
+#include "signature.h"
+#include "unit.h"
+
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace units
+{
+    /// <summary>
+    /// A unit that is only known at runtime, e.g. one parsed from text: its dimensions,
+    /// and the scale and offset which convert a value in it to the standard unit. Only affine
+    /// temperature units (°C, °F) have an offset.
+    /// </summary>
+    struct RuntimeUnit
+    {
+        double scale = 1.0;
+        Signature signature;
+        double offset = 0.0;
+    };
+
+    class IngestError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    namespace symbols
+    {
+        //builds a Signature from exponents given in the order of tag_index
+        constexpr Signature dims(int length, int mass = 0, int time = 0, int current = 0, int temperature = 0,
+            int amount = 0, int luminosity = 0, int currency = 0, int angle = 0)noexcept
+        {
+            return Signature{ { length, mass, time, current, temperature, amount, luminosity, currency, angle } };
+        }
+
+        struct Symbol
+        {
+            std::string_view text;
+            double scale;
+            Signature signature;
+            double offset = 0.0;
+        };
+
+        //unit symbols, with the scale (and for affine temperatures, the offset) to the standard unit of their quantity
+        constexpr Symbol table[] =
+        {
+            { "m", 1.0, dims(1) },
+            { "g", 1e-3, dims(0, 1) },
+            { "s", 1.0, dims(0, 0, 1) },
+            { "A", 1.0, dims(0, 0, 0, 1) },
+            { "K", 1.0, dims(0, 0, 0, 0, 1) },
+            { "\xC2\xB0" "C", 1.0, dims(0, 0, 0, 0, 1), 273.15 },
+            { "degC", 1.0, dims(0, 0, 0, 0, 1), 273.15 },
+            { "\xC2\xB0" "F", 5.0 / 9.0, dims(0, 0, 0, 0, 1), 459.67 * 5.0 / 9.0 },
+            { "degF", 5.0 / 9.0, dims(0, 0, 0, 0, 1), 459.67 * 5.0 / 9.0 },
+            { "mol", 1.0, dims(0, 0, 0, 0, 0, 1) },
+            { "cd", 1.0, dims(0, 0, 0, 0, 0, 0, 1) },
+            { "rad", 1.0, dims(0, 0, 0, 0, 0, 0, 0, 0, 1) },
+            { "deg", 3.14159265358979323846 / 180.0, dims(0, 0, 0, 0, 0, 0, 0, 0, 1) },
+            { "\xC2\xB0", 3.14159265358979323846 / 180.0, dims(0, 0, 0, 0, 0, 0, 0, 0, 1) },
+            { "min", 60.0, dims(0, 0, 1) },
+            { "h", 3600.0, dims(0, 0, 1) },
+            { "L", 1e-3, dims(3) },
+            { "l", 1e-3, dims(3) },
+            { "Hz", 1.0, dims(0, 0, -1) },
+            { "N", 1.0, dims(1, 1, -2) },
+            { "J", 1.0, dims(2, 1, -2) },
+            { "W", 1.0, dims(2, 1, -3) },
+            { "Pa", 1.0, dims(-1, 1, -2) },
+            { "bar", 1e5, dims(-1, 1, -2) },
+            { "C", 1.0, dims(0, 0, 1, 1) },
+            { "V", 1.0, dims(2, 1, -3, -1) },
+            { "Ohm", 1.0, dims(2, 1, -3, -2) },
+            { "\xCE\xA9", 1.0, dims(2, 1, -3, -2) },
+            { "F", 1.0, dims(-2, -1, 4, 2) },
+            { "Wb", 1.0, dims(2, 1, -2, -1) },
+            { "T", 1.0, dims(0, 1, -2, -1) },
+            { "%", 0.01, dims(0) },
+        };
+
+        struct Prefix
+        {
+            std::string_view text;
+            double scale;
+        };
+
+        //"da" must be tried before "d"
+        constexpr Prefix prefixes[] =
+        {
+            { "da", 10.0 }, { "G", 1e9 }, { "M", 1e6 }, { "k", 1000.0 }, { "h", 100.0 }, { "d", 0.1 },
+            { "c", 0.01 }, { "m", 0.001 }, { "u", 1e-6 }, { "\xC2\xB5", 1e-6 }, { "\xCE\xBC", 1e-6 }, { "n", 1e-9 },
+        };
+
+        constexpr const Symbol* find(std::string_view text)noexcept
+        {
+            for (const auto& symbol : table)
+            {
+                if (symbol.text == text) return &symbol;
+            }
+            return nullptr;
+        }
+
+        constexpr std::optional<RuntimeUnit> lookup(std::string_view text)noexcept
+        {
+            if (text == "1") return RuntimeUnit{};
+            if (const Symbol* symbol = find(text)) return RuntimeUnit{ symbol->scale, symbol->signature, symbol->offset };
+            for (const auto& prefix : prefixes)
+            {
+                if (text.size() <= prefix.text.size() || text.substr(0, prefix.text.size()) != prefix.text) continue;
+                if (const Symbol* symbol = find(text.substr(prefix.text.size())); symbol && symbol->offset == 0.0)
+                {
+                    return RuntimeUnit{ prefix.scale * symbol->scale, symbol->signature };
+                }
+            }
+            return std::nullopt;
+        }
+
+        //superscript digits 0-9 in UTF-8
+        constexpr std::string_view superscripts[] =
+        {
+            "\xE2\x81\xB0", "\xC2\xB9", "\xC2\xB2", "\xC2\xB3", "\xE2\x81\xB4",
+            "\xE2\x81\xB5", "\xE2\x81\xB6", "\xE2\x81\xB7", "\xE2\x81\xB8", "\xE2\x81\xB9",
+        };
+        constexpr std::string_view superscript_minus = "\xE2\x81\xBB";
+        constexpr std::string_view middle_dot = "\xC2\xB7";
+
+        constexpr int superscriptDigit(std::string_view text)noexcept
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                if (text.starts_with(superscripts[i])) return i;
+            }
+            return -1;
+        }
+
+        constexpr bool startsExponent(std::string_view text)noexcept
+        {
+            const char c = text.front();
+            return c == '^' || c == '-' || (c >= '0' && c <= '9') || text.starts_with(superscript_minus) || superscriptDigit(text) >= 0;
+        }
+
+        constexpr bool isSeparator(std::string_view text)noexcept
+        {
+            const char c = text.front();
+            return c == '*' || c == '/' || c == '.' || c == ' ' || text.starts_with(middle_dot);
+        }
+
+        //reads an exponent written as "^-2", "-2", "2" or "⁻²". returns false if there are no digits
+        constexpr bool readExponent(std::string_view& text, int& exponent)noexcept
+        {
+            int sign = 1, value = 0;
+            bool digits = false;
+            if (!text.empty() && text.front() == '^') text.remove_prefix(1);
+            if (!text.empty() && text.front() == '-') { sign = -1; text.remove_prefix(1); }
+            else if (text.starts_with(superscript_minus)) { sign = -1; text.remove_prefix(superscript_minus.size()); }
+
+            while (!text.empty())
+            {
+                if (text.front() >= '0' && text.front() <= '9')
+                {
+                    value = value * 10 + (text.front() - '0');
+                    text.remove_prefix(1);
+                }
+                else if (int d = superscriptDigit(text); d >= 0)
+                {
+                    value = value * 10 + d;
+                    text.remove_prefix(superscripts[d].size());
+                }
+                else break;
+                digits = true;
+            }
+            exponent = sign * value;
+            return digits;
+        }
+    }
+
+    /// <summary>
+    /// Parses a unit written as a product of symbols, such as "km", "m/s", "kg*m^2/s^2", "kg·m²·s⁻²" or "N.m".
+    /// Each '/' divides by the term directly after it. returns nullopt if any symbol is unknown.
+    /// Affine temperatures ("°C", "degF") only stand alone: a product or power of them has no meaning.
+    /// </summary>
+    constexpr std::optional<RuntimeUnit> parseUnit(std::string_view text)noexcept
+    {
+        RuntimeUnit out;
+        bool divide = false;
+        bool expectTerm = true;
+        bool hasOffset = false;
+        int terms = 0;
+        while (!text.empty())
+        {
+            if (symbols::isSeparator(text))
+            {
+                if (text.front() == '/')
+                {
+                    if (expectTerm && divide) return std::nullopt;
+                    divide = true;
+                    expectTerm = true;
+                }
+                text.remove_prefix(text.starts_with(symbols::middle_dot) ? symbols::middle_dot.size() : 1);
+                continue;
+            }
+
+            size_t length = 0;
+            while (length < text.size() && !symbols::isSeparator(text.substr(length)) && (length == 0 || !symbols::startsExponent(text.substr(length))))
+            {
+                ++length;
+            }
+
+            auto term = symbols::lookup(text.substr(0, length));
+            if (!term) return std::nullopt;
+            text.remove_prefix(length);
+
+            int exponent = 1;
+            if (!text.empty() && symbols::startsExponent(text) && !symbols::readExponent(text, exponent)) return std::nullopt;
+            if (divide) exponent = -exponent;
+            if (term->offset != 0.0)
+            {
+                if (exponent != 1) return std::nullopt;
+                hasOffset = true;
+                out.offset = term->offset;
+            }
+            if (++terms > 1 && hasOffset) return std::nullopt;
+
+            for (int i = 0; i < (exponent < 0 ? -exponent : exponent); ++i)
+            {
+                out.scale = exponent < 0 ? out.scale / term->scale : out.scale * term->scale;
+            }
+            out.signature *= term->signature.pow(exponent);
+            divide = false;
+            expectTerm = false;
+        }
+        if (expectTerm && divide) return std::nullopt;
+        return out;
+    }
+
+    struct IngestOptions
+    {
+        char delimiter = ',';
+        //whether the first line names the columns. a header may carry the column's unit as "name[unit]"
+        bool header = true;
+        //the number of bytes each worker parses at once. together with threads, this bounds the memory used while reading
+        size_t chunkBytes = size_t(1) << 22;
+        unsigned threads = std::thread::hardware_concurrency();
+    };
+
+    /// <summary>
+    /// Reads delimited text (CSV/TSV) into typed columns. Each column is declared as a Unit; the unit of the values
+    /// in the text comes from the header ("speed[m/s]") or from the cells themselves ("12.5 km"), is checked
+    /// against the column's Quantity once per distinct unit string, and is converted with a single affine factor.
+    /// The input is split into chunks of whole lines which are parsed in parallel, and handed back in order.
+    /// Conversions are assumed to be affine, as ratio and linear conversions are.
+    /// </summary>
+    /// <typeparam name="Units">the Unit type of each column to read</typeparam>
+    template<UnitType ... Units>
+    class TableReader
+    {
+    public:
+        static constexpr size_t n_columns = sizeof...(Units);
+        using Batch = std::tuple<std::vector<Units>...>;
+
+        //names select which columns of the header are read. if there is no header, or a name is empty, columns are taken by position
+        explicit TableReader(std::array<std::string, n_columns> names = {}, IngestOptions options = {});
+
+        //parses the stream, calling sink(Batch&&) with each parsed chunk, in the order of the input
+        template<typename Sink>
+        void read(std::istream& in, Sink&& sink);
+
+        Batch readAll(std::istream& in);
+
+    private:
+        using Affine = units::Affine<double>;
+
+        struct Column
+        {
+            size_t source = 0;
+            Affine header;
+        };
+
+        //the last unit string seen in each column's cells, so repeated units are only parsed once
+        struct CellCache
+        {
+            std::string symbol;
+            Affine affine;
+        };
+
+        template<size_t I>
+        static Affine affineFor(const RuntimeUnit& unit, std::string_view symbol, std::string_view column);
+
+        template<size_t I>
+        static Affine affineFor(std::string_view symbol, std::string_view column);
+
+        void readHeader(std::istream& in);
+        void splitLine(std::string_view line, std::vector<std::string_view>& fields)const;
+        Batch parseChunk(std::string_view chunk)const;
+
+        template<size_t I>
+        void parseCell(std::string_view cell, CellCache& cache, Batch& batch)const;
+
+        template<size_t ... Is>
+        void parseRow(const std::vector<std::string_view>& fields, std::array<CellCache, n_columns>& caches, Batch& batch, std::index_sequence<Is...>)const;
+
+        std::array<std::string, n_columns> m_names;
+        std::array<Column, n_columns> m_columns;
+        IngestOptions m_options;
+    };
+
+    namespace ingest
+    {
+        constexpr std::string_view trim(std::string_view s)noexcept
+        {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
+
+        constexpr std::string_view unquote(std::string_view s)noexcept
+        {
+            s = trim(s);
+            if (s.size() >= 2 && s.front() == '"' && s.back() == '"') s = trim(s.substr(1, s.size() - 2));
+            return s;
+        }
+    }
+
+    template<UnitType ... Units>
+    TableReader<Units...>::TableReader(std::array<std::string, n_columns> names, IngestOptions options) :
+        m_names{ std::move(names) }, m_columns{}, m_options{ options }
+    {
+        if (m_options.threads == 0) m_options.threads = 1;
+        if (m_options.chunkBytes == 0) m_options.chunkBytes = 1;
+        for (size_t i = 0; i < n_columns; ++i) m_columns[i].source = i;
+    }
+
+    template<UnitType ... Units>
+    template<size_t I>
+    typename TableReader<Units...>::Affine TableReader<Units...>::affineFor(const RuntimeUnit& unit, std::string_view symbol, std::string_view column)
+    {
+        using U = std::tuple_element_t<I, std::tuple<Units...>>;
+        using C = typename U::ConversionType;
+
+        if (unit.signature != signature_of<typename U::Quantity>)
+        {
+            throw IngestError("column '" + std::string(column) + "': unit '" + std::string(symbol) + "' has the wrong dimensions");
+        }
+        //from the column's unit to the standard unit, then on into the column type's conversion
+        const Affine fromStandard = affine<NoConversion, C, double>();
+        return Affine{ fromStandard.scale * unit.scale, fromStandard(unit.offset) };
+    }
+
+    template<UnitType ... Units>
+    template<size_t I>
+    typename TableReader<Units...>::Affine TableReader<Units...>::affineFor(std::string_view symbol, std::string_view column)
+    {
+        auto unit = parseUnit(symbol);
+        if (!unit) throw IngestError("column '" + std::string(column) + "': unknown unit '" + std::string(symbol) + "'");
+        return affineFor<I>(*unit, symbol, column);
+    }
+
+    template<UnitType ... Units>
+    void TableReader<Units...>::splitLine(std::string_view line, std::vector<std::string_view>& fields)const
+    {
+        fields.clear();
+        size_t start = 0;
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i)
+        {
+            if (line[i] == '"') quoted = !quoted;
+            else if (line[i] == m_options.delimiter && !quoted)
+            {
+                fields.push_back(line.substr(start, i - start));
+                start = i + 1;
+            }
+        }
+        fields.push_back(line.substr(start));
+    }
+
+    template<UnitType ... Units>
+    void TableReader<Units...>::readHeader(std::istream& in)
+    {
+        for (size_t i = 0; i < n_columns; ++i) m_columns[i] = Column{ i, Affine{} };
+        if (!m_options.header) return;
+
+        std::string line;
+        std::getline(in, line);
+        std::vector<std::string_view> fields;
+        splitLine(line, fields);
+
+        std::vector<std::string_view> names(fields.size()), symbols(fields.size());
+        for (size_t f = 0; f < fields.size(); ++f)
+        {
+            std::string_view field = ingest::unquote(fields[f]);
+            const size_t open = field.find('[');
+            const size_t close = field.rfind(']');
+            if (open != std::string_view::npos && close != std::string_view::npos && close > open)
+            {
+                symbols[f] = ingest::trim(field.substr(open + 1, close - open - 1));
+                field = ingest::trim(field.substr(0, open));
+            }
+            names[f] = field;
+        }
+
+        [&]<size_t ... Is>(std::index_sequence<Is...>)
+        {
+            ([&]
+            {
+                Column& column = m_columns[Is];
+                if (!m_names[Is].empty())
+                {
+                    size_t f = 0;
+                    while (f < names.size() && names[f] != m_names[Is]) ++f;
+                    if (f == names.size()) throw IngestError("no column named '" + m_names[Is] + "' in the header");
+                    column.source = f;
+                }
+                if (column.source < symbols.size() && !symbols[column.source].empty())
+                {
+                    column.header = affineFor<Is>(symbols[column.source], names[column.source]);
+                }
+            }(), ...);
+        }(std::index_sequence_for<Units...>{});
+    }
+
+    template<UnitType ... Units>
+    template<size_t I>
+    void TableReader<Units...>::parseCell(std::string_view cell, CellCache& cache, Batch& batch)const
+    {
+        using U = std::tuple_element_t<I, std::tuple<Units...>>;
+        using T = typename U::ValueType;
+
+        cell = ingest::unquote(cell);
+        if (cell.empty())
+        {
+            //a missing value is read as NaN, which integral and packed columns have no way to hold
+            if constexpr (std::numeric_limits<T>::has_quiet_NaN)
+            {
+                std::get<I>(batch).emplace_back(std::numeric_limits<T>::quiet_NaN());
+                return;
+            }
+            else throw IngestError("column '" + m_names[I] + "': empty cell in a column that can't hold NaN");
+        }
+
+        double value = 0.0;
+        auto [end, error] = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+        if (error != std::errc{})
+        {
+            throw IngestError("could not parse '" + std::string(cell) + "' as a number");
+        }
+
+        const std::string_view symbol = ingest::trim(std::string_view(end, cell.data() + cell.size() - end));
+        const Column& column = m_columns[I];
+        if (symbol.empty())
+        {
+            value = column.header(value);
+        }
+        else
+        {
+            if (symbol != cache.symbol)
+            {
+                cache.affine = affineFor<I>(symbol, m_names[I]);
+                cache.symbol = symbol;
+            }
+            value = cache.affine(value);
+        }
+        if constexpr (std::is_integral_v<T>)
+        {
+            value = std::round(value);
+            if (!(value >= static_cast<double>(std::numeric_limits<T>::min()) && value < static_cast<double>(std::numeric_limits<T>::max()) + 1.0))
+            {
+                throw IngestError("column '" + m_names[I] + "': " + std::string(cell) + " is out of range");
+            }
+        }
+        std::get<I>(batch).emplace_back(static_cast<T>(value));
+    }
+
+    template<UnitType ... Units>
+    template<size_t ... Is>
+    void TableReader<Units...>::parseRow(const std::vector<std::string_view>& fields, std::array<CellCache, n_columns>& caches, Batch& batch, std::index_sequence<Is...>)const
+    {
+        (parseCell<Is>(m_columns[Is].source < fields.size() ? fields[m_columns[Is].source] : std::string_view{}, caches[Is], batch), ...);
+    }
+
+    template<UnitType ... Units>
+    typename TableReader<Units...>::Batch TableReader<Units...>::parseChunk(std::string_view chunk)const
+    {
+        Batch batch;
+        std::array<CellCache, n_columns> caches;
+        std::vector<std::string_view> fields;
+
+        //a rough guess at the row count, so the columns are not regrown repeatedly
+        const size_t rows = chunk.size() / (8 * n_columns + 1) + 1;
+        std::apply([rows](auto& ... columns) { (columns.reserve(rows), ...); }, batch);
+
+        while (!chunk.empty())
+        {
+            size_t end = chunk.find('\n');
+            std::string_view line = chunk.substr(0, end);
+            chunk.remove_prefix(end == std::string_view::npos ? chunk.size() : end + 1);
+
+            if (ingest::trim(line).empty()) continue;
+            splitLine(line, fields);
+            parseRow(fields, caches, batch, std::index_sequence_for<Units...>{});
+        }
+        return batch;
+    }
+
+    template<UnitType ... Units>
+    template<typename Sink>
+    void TableReader<Units...>::read(std::istream& in, Sink&& sink)
+    {
+        readHeader(in);
+
+        std::string carry;
+        std::vector<std::string> chunks;
+        std::vector<Batch> batches;
+        std::vector<std::exception_ptr> errors;
+        auto work = [&](size_t i)
+        {
+            try { batches[i] = parseChunk(chunks[i]); }
+            catch (...) { errors[i] = std::current_exception(); }
+        };
+
+        //one set of workers for the whole read. each round, worker w parses chunk w and the calling thread chunk 0;
+        //chunks, batches and errors are only touched by the calling thread between rounds
+        std::mutex mutex;
+        std::condition_variable started, finished;
+        size_t round = 0, pending = 0;
+        bool stop = false;
+
+        std::vector<std::thread> workers;
+        workers.reserve(m_options.threads - 1);
+        for (size_t w = 1; w < m_options.threads; ++w)
+        {
+            workers.emplace_back([&, w]
+            {
+                for (size_t seen = 0;; ++seen)
+                {
+                    {
+                        std::unique_lock lock(mutex);
+                        started.wait(lock, [&] { return stop || round != seen; });
+                        if (stop) return;
+                    }
+                    if (w < chunks.size()) work(w);
+                    std::lock_guard lock(mutex);
+                    if (--pending == 0) finished.notify_one();
+                }
+            });
+        }
+
+        //stops and joins the workers however the read ends, including when the sink throws
+        auto shutdown = [&]
+        {
+            {
+                std::lock_guard lock(mutex);
+                stop = true;
+            }
+            started.notify_all();
+            for (auto& worker : workers) worker.join();
+        };
+
+        try
+        {
+            while (in)
+            {
+                //fill up to one chunk per thread, each ending on a line boundary
+                chunks.clear();
+                while (chunks.size() < m_options.threads && in)
+                {
+                    std::string buffer = std::move(carry);
+                    carry.clear();
+                    const size_t kept = buffer.size();
+                    buffer.resize(kept + m_options.chunkBytes);
+                    in.read(buffer.data() + kept, static_cast<std::streamsize>(m_options.chunkBytes));
+                    buffer.resize(kept + static_cast<size_t>(in.gcount()));
+
+                    if (in)
+                    {
+                        const size_t lastLine = buffer.rfind('\n');
+                        if (lastLine == std::string::npos)
+                        {
+                            //a single line longer than a chunk: keep reading it
+                            carry = std::move(buffer);
+                            continue;
+                        }
+                        carry.assign(buffer, lastLine + 1);
+                        buffer.resize(lastLine + 1);
+                    }
+                    chunks.push_back(std::move(buffer));
+                }
+                if (chunks.empty()) continue;
+
+                batches.assign(chunks.size(), Batch{});
+                errors.assign(chunks.size(), nullptr);
+                {
+                    std::lock_guard lock(mutex);
+                    pending = workers.size();
+                    ++round;
+                }
+                started.notify_all();
+                work(0);
+                {
+                    std::unique_lock lock(mutex);
+                    finished.wait(lock, [&] { return pending == 0; });
+                }
+
+                for (size_t i = 0; i < batches.size(); ++i)
+                {
+                    if (errors[i]) std::rethrow_exception(errors[i]);
+                    sink(std::move(batches[i]));
+                }
+            }
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+        shutdown();
+    }
+
+    template<UnitType ... Units>
+    typename TableReader<Units...>::Batch TableReader<Units...>::readAll(std::istream& in)
+    {
+        Batch out;
+        read(in, [&out](Batch&& batch)
+        {
+            [&]<size_t ... Is>(std::index_sequence<Is...>)
+            {
+                (std::get<Is>(out).insert(std::get<Is>(out).end(), std::get<Is>(batch).begin(), std::get<Is>(batch).end()), ...);
+            }(std::index_sequence_for<Units...>{});
+        });
+        return out;
+    }
+}
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef UNITS_LOOKUP_H
+#define UNITS_LOOKUP_H
+
+#include "conversions.h"
+#include "unit.h"
+
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace units
+{
+    namespace lookup
+    {
+        //the type positions between the points of an axis of N are measured in, so integral axes still interpolate
+        template<typename N>
+        using Fraction = BoolTypePredicate<std::is_integral_v<N>, N, double>;
+
+        //converts units of any conversion into values in To, with one factor for the whole range
+        template<typename To, typename N, typename U>
+        std::vector<N> normalise(std::span<const U> units)
+        {
+            const Affine<Fraction<N>> f = affine<typename U::ConversionType, To, Fraction<N>>();
+            std::vector<N> out(units.size());
+            for (size_t i = 0; i < units.size(); ++i) out[i] = static_cast<N>(f(static_cast<Fraction<N>>(units[i].value())));
+            return out;
+        }
+
+        /// <summary>
+        /// A strictly increasing axis and the search that brackets a value on it. Axes spaced evenly (to within rounding)
+        /// are found by index arithmetic; others by a binary search with no data-dependent branches, so a batch
+        /// of lookups is limited by its loads rather than by mispredictions.
+        /// </summary>
+        template<typename N>
+        class Axis
+        {
+        public:
+            Axis() = default;
+            explicit Axis(std::vector<N> points);
+
+            size_t size()const noexcept { return m_points.size(); }
+            const std::vector<N>& points()const noexcept { return m_points; }
+            bool isUniform()const noexcept { return m_uniform; }
+
+            //the interval x falls in, and how far along it, clamped to the ends of the axis
+            void bracket(Fraction<N> x, size_t& i, Fraction<N>& t)const noexcept
+            {
+                using F = Fraction<N>;
+                const N* p = m_points.data();
+                const size_t last = m_points.size() - 2;
+                if (m_uniform)
+                {
+                    F f = (x - F(p[0])) * m_inverseStep;
+                    f = f > F(0) ? f : F(0);
+                    f = f < F(last + 1) ? f : F(last + 1);
+                    i = static_cast<size_t>(f);
+                    i = i < last ? i : last;
+                    t = f - F(i);
+                }
+                else
+                {
+                    const N* base = p;
+                    size_t length = last + 1;
+                    while (length > 1)
+                    {
+                        const size_t half = length / 2;
+                        base = base[half] <= x ? base + half : base;
+                        length -= half;
+                    }
+                    i = static_cast<size_t>(base - p);
+                    t = (x - F(p[i])) / (F(p[i + 1]) - F(p[i]));
+                    t = t > F(0) ? t : F(0);
+                    t = t < F(1) ? t : F(1);
+                }
+            }
+
+        private:
+            std::vector<N> m_points;
+            Fraction<N> m_inverseStep{};
+            bool m_uniform = false;
+        };
+
+        template<typename N>
+        Axis<N>::Axis(std::vector<N> points) : m_points{ std::move(points) }
+        {
+            if (m_points.size() < 2) throw std::invalid_argument("a lookup table axis needs at least two points");
+            for (size_t i = 1; i < m_points.size(); ++i)
+            {
+                if (!(m_points[i] > m_points[i - 1])) throw std::invalid_argument("a lookup table axis must be strictly increasing");
+            }
+
+            using F = Fraction<N>;
+            const F step = (F(m_points.back()) - F(m_points.front())) / F(m_points.size() - 1);
+            m_uniform = true;
+            for (size_t i = 0; i < m_points.size() && m_uniform; ++i)
+            {
+                m_uniform = std::abs(F(m_points[i]) - (F(m_points.front()) + F(i) * step)) <= step * F(1e-9);
+            }
+            m_inverseStep = F(1) / step;
+        }
+    }
+
+    /// <summary>
+    /// A table of Y against X with linear interpolation, e.g. LookupTable&lt;kelvins&lt;double&gt;, Unit&lt;double, quantities::Density&gt;&gt;.
+    /// Axis and values are converted into X's and Y's conversions once, on construction; queries in other conversions
+    /// of the same quantity are converted by one scale and offset per batch. Queries beyond the axis take the end values.
+    /// The axis is kept in X's numeric type and the values in Y's, so neither is rounded to the other.
+    /// </summary>
+    template<UnitType X, UnitType Y>
+    class LookupTable
+    {
+    public:
+        using AxisType = ComputeType<typename X::ValueType>;
+        using ValueType = ComputeType<typename Y::ValueType>;
+
+        template<UnitType XIn, UnitType YIn>
+        LookupTable(std::span<const XIn> axis, std::span<const YIn> values);
+
+        template<UnitType XIn, UnitType YIn>
+        LookupTable(const std::vector<XIn>& axis, const std::vector<YIn>& values) :
+            LookupTable(std::span<const XIn>(axis), std::span<const YIn>(values)) {}
+
+        template<UnitType XIn>
+        Y operator()(const XIn& x)const;
+
+        //evaluates the table at every query, writing into out, which must be as long as xs
+        template<UnitType XIn>
+        void evaluate(std::span<const XIn> xs, std::span<Y> out)const;
+
+        template<UnitType XIn>
+        void evaluate(const std::vector<XIn>& xs, std::vector<Y>& out)const { evaluate(std::span<const XIn>(xs), std::span<Y>(out)); }
+
+    private:
+        auto at(lookup::Fraction<AxisType> x)const noexcept
+        {
+            size_t i;
+            lookup::Fraction<AxisType> t;
+            m_axis.bracket(x, i, t);
+            return m_values[i] + t * (m_values[i + 1] - m_values[i]);
+        }
+
+        lookup::Axis<AxisType> m_axis;
+        std::vector<ValueType> m_values;
+    };
+
+    /// <summary>
+    /// A table of Z against X and Y with bilinear interpolation, e.g. density against temperature and pressure.
+    /// Values are given row by row: the value at (x[i], y[j]) is values[i * y.size() + j].
+    /// Conversions are normalised the same way as LookupTable's.
+    /// </summary>
+    template<UnitType X, UnitType Y, UnitType Z>
+    class LookupTable2D
+    {
+    public:
+        using XAxisType = ComputeType<typename X::ValueType>;
+        using YAxisType = ComputeType<typename Y::ValueType>;
+        using ValueType = ComputeType<typename Z::ValueType>;
+
+        template<UnitType XIn, UnitType YIn, UnitType ZIn>
+        LookupTable2D(std::span<const XIn> xAxis, std::span<const YIn> yAxis, std::span<const ZIn> values);
+
+        template<UnitType XIn, UnitType YIn, UnitType ZIn>
+        LookupTable2D(const std::vector<XIn>& xAxis, const std::vector<YIn>& yAxis, const std::vector<ZIn>& values) :
+            LookupTable2D(std::span<const XIn>(xAxis), std::span<const YIn>(yAxis), std::span<const ZIn>(values)) {}
+
+        template<UnitType XIn, UnitType YIn>
+        Z operator()(const XIn& x, const YIn& y)const;
+
+        //evaluates the table at every pair of queries, writing into out, which must be as long as xs and ys
+        template<UnitType XIn, UnitType YIn>
+        void evaluate(std::span<const XIn> xs, std::span<const YIn> ys, std::span<Z> out)const;
+
+        template<UnitType XIn, UnitType YIn>
+        void evaluate(const std::vector<XIn>& xs, const std::vector<YIn>& ys, std::vector<Z>& out)const
+        {
+            evaluate(std::span<const XIn>(xs), std::span<const YIn>(ys), std::span<Z>(out));
+        }
+
+    private:
+        auto at(lookup::Fraction<XAxisType> x, lookup::Fraction<YAxisType> y)const noexcept
+        {
+            size_t i, j;
+            lookup::Fraction<XAxisType> u;
+            lookup::Fraction<YAxisType> v;
+            m_xAxis.bracket(x, i, u);
+            m_yAxis.bracket(y, j, v);
+            const size_t stride = m_yAxis.size();
+            const ValueType* row0 = m_values.data() + i * stride + j;
+            const ValueType* row1 = row0 + stride;
+            const auto z0 = row0[0] + v * (row0[1] - row0[0]);
+            const auto z1 = row1[0] + v * (row1[1] - row1[0]);
+            return z0 + u * (z1 - z0);
+        }
+
+        lookup::Axis<XAxisType> m_xAxis;
+        lookup::Axis<YAxisType> m_yAxis;
+        std::vector<ValueType> m_values;
+    };
+
+    template<UnitType X, UnitType Y>
+    template<UnitType XIn, UnitType YIn>
+    LookupTable<X, Y>::LookupTable(std::span<const XIn> axis, std::span<const YIn> values) :
+        m_axis{ lookup::normalise<typename X::ConversionType, AxisType>(axis) },
+        m_values{ lookup::normalise<typename Y::ConversionType, ValueType>(values) }
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "axis must have the table's X quantity");
+        static_assert(b_is_same<typename YIn::Quantity, typename Y::Quantity>, "values must have the table's Y quantity");
+        if (m_values.size() != m_axis.size()) throw std::invalid_argument("a lookup table needs one value per axis point");
+    }
+
+    template<UnitType X, UnitType Y>
+    template<UnitType XIn>
+    Y LookupTable<X, Y>::operator()(const XIn& x)const
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "query must have the table's X quantity");
+        using F = lookup::Fraction<AxisType>;
+        const Affine<F> f = affine<typename XIn::ConversionType, typename X::ConversionType, F>();
+        return Y(static_cast<typename Y::ValueType>(at(f(static_cast<F>(x.value())))));
+    }
+
+    template<UnitType X, UnitType Y>
+    template<UnitType XIn>
+    void LookupTable<X, Y>::evaluate(std::span<const XIn> xs, std::span<Y> out)const
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "queries must have the table's X quantity");
+        if (out.size() != xs.size()) throw std::invalid_argument("a lookup table writes one value per query");
+        using F = lookup::Fraction<AxisType>;
+        const Affine<F> f = affine<typename XIn::ConversionType, typename X::ConversionType, F>();
+        for (size_t k = 0; k < xs.size(); ++k)
+        {
+            out[k] = Y(static_cast<typename Y::ValueType>(at(f(static_cast<F>(xs[k].value())))));
+        }
+    }
+
+    template<UnitType X, UnitType Y, UnitType Z>
+    template<UnitType XIn, UnitType YIn, UnitType ZIn>
+    LookupTable2D<X, Y, Z>::LookupTable2D(std::span<const XIn> xAxis, std::span<const YIn> yAxis, std::span<const ZIn> values) :
+        m_xAxis{ lookup::normalise<typename X::ConversionType, XAxisType>(xAxis) },
+        m_yAxis{ lookup::normalise<typename Y::ConversionType, YAxisType>(yAxis) },
+        m_values{ lookup::normalise<typename Z::ConversionType, ValueType>(values) }
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "x axis must have the table's X quantity");
+        static_assert(b_is_same<typename YIn::Quantity, typename Y::Quantity>, "y axis must have the table's Y quantity");
+        static_assert(b_is_same<typename ZIn::Quantity, typename Z::Quantity>, "values must have the table's Z quantity");
+        if (m_values.size() != m_xAxis.size() * m_yAxis.size()) throw std::invalid_argument("a lookup table needs one value per pair of axis points");
+    }
+
+    template<UnitType X, UnitType Y, UnitType Z>
+    template<UnitType XIn, UnitType YIn>
+    Z LookupTable2D<X, Y, Z>::operator()(const XIn& x, const YIn& y)const
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "x query must have the table's X quantity");
+        static_assert(b_is_same<typename YIn::Quantity, typename Y::Quantity>, "y query must have the table's Y quantity");
+        using FX = lookup::Fraction<XAxisType>;
+        using FY = lookup::Fraction<YAxisType>;
+        const Affine<FX> fx = affine<typename XIn::ConversionType, typename X::ConversionType, FX>();
+        const Affine<FY> fy = affine<typename YIn::ConversionType, typename Y::ConversionType, FY>();
+        return Z(static_cast<typename Z::ValueType>(at(fx(static_cast<FX>(x.value())), fy(static_cast<FY>(y.value())))));
+    }
+
+    template<UnitType X, UnitType Y, UnitType Z>
+    template<UnitType XIn, UnitType YIn>
+    void LookupTable2D<X, Y, Z>::evaluate(std::span<const XIn> xs, std::span<const YIn> ys, std::span<Z> out)const
+    {
+        static_assert(b_is_same<typename XIn::Quantity, typename X::Quantity>, "x queries must have the table's X quantity");
+        static_assert(b_is_same<typename YIn::Quantity, typename Y::Quantity>, "y queries must have the table's Y quantity");
+        if (ys.size() != xs.size() || out.size() != xs.size()) throw std::invalid_argument("a lookup table writes one value per pair of queries");
+        using FX = lookup::Fraction<XAxisType>;
+        using FY = lookup::Fraction<YAxisType>;
+        const Affine<FX> fx = affine<typename XIn::ConversionType, typename X::ConversionType, FX>();
+        const Affine<FY> fy = affine<typename YIn::ConversionType, typename Y::ConversionType, FY>();
+        for (size_t k = 0; k < xs.size(); ++k)
+        {
+            out[k] = Z(static_cast<typename Z::ValueType>(at(fx(static_cast<FX>(xs[k].value())), fy(static_cast<FY>(ys[k].value())))));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef UNITS_NAMES_H
+#define UNITS_NAMES_H
+
+#include "conversions.h"
+#include "quantity.h"
+#include "tags.h"
+#include "unit.h"
+
+#include <string_view>
+
+namespace units
+{
+    /// <summary>
+    /// A string of fixed length held by value, so that it can be built and stored at compile time.
+    /// Always null terminated.
+    /// </summary>
+    template<size_t N>
+    struct FixedString
+    {
+        char data[N + 1]{};
+
+        constexpr FixedString() = default;
+        constexpr FixedString(const char(&str)[N + 1])noexcept
+        {
+            for (size_t i = 0; i < N; ++i) data[i] = str[i];
+        }
+
+        static constexpr size_t size()noexcept { return N; }
+        constexpr const char* c_str()const noexcept { return data; }
+        constexpr std::string_view view()const noexcept { return std::string_view(data, N); }
+        constexpr operator std::string_view()const noexcept { return view(); }
+    };
+
+    template<size_t N>
+    FixedString(const char(&)[N]) -> FixedString<N - 1>;
+
+    template<size_t N, size_t M>
+    constexpr bool operator==(const FixedString<N>& s1, const FixedString<M>& s2)noexcept { return s1.view() == s2.view(); }
+
+    template<size_t N, size_t M>
+    constexpr FixedString<N + M> operator+(const FixedString<N>& s1, const FixedString<M>& s2)noexcept
+    {
+        FixedString<N + M> out;
+        for (size_t i = 0; i < N; ++i) out.data[i] = s1.data[i];
+        for (size_t i = 0; i < M; ++i) out.data[N + i] = s2.data[i];
+        return out;
+    }
+
+    /// <summary>
+    /// The name and symbol of a tag. User-defined tags can provide static constexpr FixedString members
+    /// `name` and `symbol` instead of specialising this.
+    /// </summary>
+    template<typename Tag>
+    struct TagName
+    {
+        static constexpr auto name = Tag::name;
+        static constexpr auto symbol = Tag::symbol;
+    };
+
+    template<> struct TagName<tags::Time> { static constexpr FixedString name = "time"; static constexpr FixedString symbol = "s"; };
+    template<> struct TagName<tags::Length> { static constexpr FixedString name = "length"; static constexpr FixedString symbol = "m"; };
+    template<> struct TagName<tags::Mass> { static constexpr FixedString name = "mass"; static constexpr FixedString symbol = "kg"; };
+    template<> struct TagName<tags::Current> { static constexpr FixedString name = "current"; static constexpr FixedString symbol = "A"; };
+    template<> struct TagName<tags::Temperature> { static constexpr FixedString name = "temperature"; static constexpr FixedString symbol = "K"; };
+    template<> struct TagName<tags::Amount> { static constexpr FixedString name = "amount"; static constexpr FixedString symbol = "mol"; };
+    template<> struct TagName<tags::Luminosity> { static constexpr FixedString name = "luminosity"; static constexpr FixedString symbol = "cd"; };
+    template<> struct TagName<tags::Currency> { static constexpr FixedString name = "currency"; static constexpr FixedString symbol = "\xC2\xA4"; };
+    template<> struct TagName<tags::Angle> { static constexpr FixedString name = "angle"; static constexpr FixedString symbol = "rad"; };
+
+    //the order dimensions are written in within a quantity, following the SI convention (kg·m²·s⁻²).
+    //user-defined tags come last, in the order they appear in the quantity
+    template<typename Tag>
+    constexpr int tag_rank = 9;
+
+    template<> constexpr int tag_rank<tags::Mass> = 0;
+    template<> constexpr int tag_rank<tags::Length> = 1;
+    template<> constexpr int tag_rank<tags::Time> = 2;
+    template<> constexpr int tag_rank<tags::Current> = 3;
+    template<> constexpr int tag_rank<tags::Temperature> = 4;
+    template<> constexpr int tag_rank<tags::Amount> = 5;
+    template<> constexpr int tag_rank<tags::Luminosity> = 6;
+    template<> constexpr int tag_rank<tags::Currency> = 7;
+    template<> constexpr int tag_rank<tags::Angle> = 8;
+
+    /// <summary>
+    /// The name and symbol of a conversion. By default both are the name given to the conversion macro;
+    /// b_prefix marks conversions whose symbol is written directly before the quantity's (k, m, µ...), and
+    /// b_standalone those whose symbol is the whole unit (°C).
+    /// mass_symbol is a prefix conversion's whole symbol for mass, whose standard unit already carries a prefix (kg):
+    /// milli kilograms are grams, not "mkg".
+    /// </summary>
+    template<typename C>
+    struct ConversionName
+    {
+        static constexpr FixedString name = C::conversion_name;
+        static constexpr FixedString symbol = C::conversion_name;
+        static constexpr FixedString mass_symbol = "";
+        static constexpr bool b_prefix = false;
+        static constexpr bool b_standalone = false;
+    };
+
+#define UNITS_CONVERSION_SYMBOL(conversion, sym, mass, prefix, standalone)\
+    template<> struct ConversionName<conversion>\
+    {\
+        static constexpr FixedString name = conversion::conversion_name;\
+        static constexpr FixedString symbol = sym;\
+        static constexpr FixedString mass_symbol = mass;\
+        static constexpr bool b_prefix = prefix;\
+        static constexpr bool b_standalone = standalone;\
+    };
+
+    //hecta and deca kilograms (10⁵ g and 10⁴ g) have no SI prefix
+    UNITS_CONVERSION_SYMBOL(NoConversion, "", "kg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::giga, "G", "Tg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::mega, "M", "Gg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::kilo, "k", "Mg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::hecta, "h", "10\xE2\x81\xB5 g", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::deca, "da", "10\xE2\x81\xB4 g", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::deci, "d", "hg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::centi, "c", "dag", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::milli, "m", "g", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::micro, "\xC2\xB5", "mg", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::nano, "n", "\xC2\xB5g", true, false)
+    UNITS_CONVERSION_SYMBOL(conversions::decibel, "dB", "", false, false)
+    UNITS_CONVERSION_SYMBOL(conversions::celsius, "\xC2\xB0" "C", "", false, true)
+    UNITS_CONVERSION_SYMBOL(conversions::celsius::Delta, "\xCE\x94\xC2\xB0" "C", "", false, true)
+    UNITS_CONVERSION_SYMBOL(conversions::fahrenheit, "\xC2\xB0" "F", "", false, true)
+    UNITS_CONVERSION_SYMBOL(conversions::fahrenheit::Delta, "\xCE\x94\xC2\xB0" "F", "", false, true)
+
+#undef UNITS_CONVERSION_SYMBOL
+
+    namespace names
+    {
+        //scratch space for composing a string at compile time, before it is copied into a FixedString of the right size
+        struct Buffer
+        {
+            char data[256]{};
+            size_t size = 0;
+
+            constexpr Buffer& operator+=(std::string_view str)noexcept
+            {
+                for (char c : str) data[size++] = c;
+                return *this;
+            }
+        };
+
+        template<auto Build>
+        constexpr auto fix()noexcept
+        {
+            constexpr Buffer buffer = Build();
+            FixedString<buffer.size> out;
+            for (size_t i = 0; i < buffer.size; ++i) out.data[i] = buffer.data[i];
+            return out;
+        }
+
+        constexpr void appendInteger(Buffer& buffer, int value)noexcept
+        {
+            if (value < 0) { buffer += "-"; value = -value; }
+            char digits[12]{};
+            int n = 0;
+            do { digits[n++] = static_cast<char>('0' + value % 10); value /= 10; } while (value);
+            while (n) buffer += std::string_view(&digits[--n], 1);
+        }
+
+        constexpr void appendSuperscript(Buffer& buffer, int value)noexcept
+        {
+            constexpr std::string_view superscripts[] =
+            {
+                "\xE2\x81\xB0", "\xC2\xB9", "\xC2\xB2", "\xC2\xB3", "\xE2\x81\xB4",
+                "\xE2\x81\xB5", "\xE2\x81\xB6", "\xE2\x81\xB7", "\xE2\x81\xB8", "\xE2\x81\xB9",
+            };
+            if (value < 0) { buffer += "\xE2\x81\xBB"; value = -value; }
+            int digits[12]{};
+            int n = 0;
+            do { digits[n++] = value % 10; value /= 10; } while (value);
+            while (n) buffer += superscripts[digits[--n]];
+        }
+
+        template<typename DimensionType>
+        struct DimensionName;
+
+        template<typename Tag, int e>
+        struct DimensionName<Dimension<Tag, e>>
+        {
+            static constexpr Buffer name()noexcept
+            {
+                Buffer buffer;
+                buffer += TagName<Tag>::name;
+                if (e != 1) { buffer += "^"; appendInteger(buffer, e); }
+                return buffer;
+            }
+
+            static constexpr Buffer symbol()noexcept
+            {
+                Buffer buffer;
+                buffer += TagName<Tag>::symbol;
+                if (e != 1) appendSuperscript(buffer, e);
+                return buffer;
+            }
+        };
+
+        template<typename QuantityType>
+        struct QuantityName;
+
+        template<typename ... Dims>
+        struct QuantityName<Quantity<Dims...>>
+        {
+            //joins the dimensions in order of their tag's rank, or returns "1" for a dimensionless quantity
+            template<bool symbols>
+            static constexpr Buffer join()noexcept
+            {
+                Buffer buffer;
+                bool first = true;
+                auto append = [&](const Buffer& part)
+                {
+                    if (!first) buffer += "\xC2\xB7";
+                    buffer += std::string_view(part.data, part.size);
+                    first = false;
+                };
+                for (int rank = 0; rank <= 9; ++rank)
+                {
+                    ((tag_rank<typename Dims::dimension> == rank ?
+                        append(symbols ? DimensionName<Dims>::symbol() : DimensionName<Dims>::name()) : void()), ...);
+                }
+                if (first) buffer += "1";
+                return buffer;
+            }
+
+            static constexpr Buffer name()noexcept { return join<false>(); }
+            static constexpr Buffer symbol()noexcept { return join<true>(); }
+
+            //whether a prefix has to be bracketed to apply to the whole quantity, as in k(m²) rather than km²
+            static constexpr bool b_compound = sizeof...(Dims) > 1 || ((Dims::exponent != 1) || ...);
+        };
+
+        template<typename UnitType>
+        struct UnitName;
+
+        template<typename N, typename Q, typename C>
+        struct UnitName<Unit<N, Q, C>>
+        {
+            static constexpr Buffer symbol()noexcept
+            {
+                using Conversion = ConversionName<C>;
+                using Simplified = names::QuantityName<typename Q::Simplified>;
+                const Buffer quantity = Simplified::symbol();
+                const std::string_view q(quantity.data, quantity.size);
+
+                Buffer buffer;
+                if (Conversion::b_standalone)
+                {
+                    buffer += Conversion::symbol;
+                }
+                else if (Conversion::b_prefix && b_is_same<typename Q::Simplified, typename Quantity<Dimension<tags::Mass, 1>>::Simplified>)
+                {
+                    buffer += Conversion::mass_symbol;
+                }
+                else if (Conversion::b_prefix)
+                {
+                    buffer += Conversion::symbol;
+                    if (Simplified::b_compound && Conversion::symbol.size()) { buffer += "("; buffer += q; buffer += ")"; }
+                    else buffer += q;
+                }
+                else
+                {
+                    buffer += Conversion::symbol;
+                    buffer += " ";
+                    buffer += q;
+                }
+                return buffer;
+            }
+        };
+    }
+
+    template<typename Tag>
+    constexpr auto tag_name = FixedString(TagName<Tag>::name);
+
+    template<typename Tag>
+    constexpr auto tag_symbol = FixedString(TagName<Tag>::symbol);
+
+    template<typename DimensionType>
+    constexpr auto dimension_name = names::fix<&names::DimensionName<DimensionType>::name>();
+
+    template<typename DimensionType>
+    constexpr auto dimension_symbol = names::fix<&names::DimensionName<DimensionType>::symbol>();
+
+    //e.g. "mass·length^2·time^-2" for quantities::Energy
+    template<QuantityType Q>
+    constexpr auto quantity_name = names::fix<&names::QuantityName<typename Q::Simplified>::name>();
+
+    //e.g. "kg·m²·s⁻²" for quantities::Energy
+    template<QuantityType Q>
+    constexpr auto quantity_symbol = names::fix<&names::QuantityName<typename Q::Simplified>::symbol>();
+
+    template<typename C>
+    constexpr auto conversion_name = ConversionName<C>::name;
+
+    template<typename C>
+    constexpr auto conversion_symbol = ConversionName<C>::symbol;
+
+    //e.g. "km" for kilometres, "k(kg·m²·s⁻²)" for a kilo Energy, "°C" for degreesCelsius
+    template<UnitType U>
+    constexpr auto unit_symbol = names::fix<&names::UnitName<U>::symbol>();
+}
+
+#endif
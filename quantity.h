@@ -3,6 +3,8 @@
 #include "dimension.h"
 #include "typelist.h"
 
+#include <utility>
+
 namespace units
 {       
     /// <summary>
@@ -184,6 +186,10 @@ namespace units
         quantities::HasDimensions<quantities::ReducedDimensionsList<Dims1...>, quantities::ReducedDimensionsList<Dims2...>, quantities::ReducedDimensionsList<Dims2...>>::value &&
         quantities::HasDimensions<quantities::ReducedDimensionsList<Dims2...>, quantities::ReducedDimensionsList<Dims1...>, quantities::ReducedDimensionsList<Dims1...>>::value;
 
+    //resolves the ambiguity between the above and b_is_same<T, T>
+    template<typename ... Dims>
+    constexpr bool b_is_same<Quantity<Dims...>, Quantity<Dims...>> = true;
+
     template<typename ... Dimensions>
     struct Quantity
     {
@@ -213,6 +219,16 @@ namespace units
 
     template<typename ... Dims>
     constexpr bool b_is_quantity<Quantity<Dims...>> = true;
+
+    template<typename T>
+    concept QuantityType = b_is_quantity<T>;
+
+    //whether a quantity reduces to no dimensions, e.g. Length / Length. Angle has a dimension of its own, so isn't
+    template<typename T>
+    constexpr bool b_is_dimensionless = false;
+
+    template<typename ... Dims>
+    constexpr bool b_is_dimensionless<Quantity<Dims...>> = b_is_same<Quantity<Dims...>, Quantity<>>;
 }
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef UNITS_QUANTIZED_H
+#define UNITS_QUANTIZED_H
+
+#include "unit.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+
+namespace units
+{
+    /// <summary>
+    /// A narrow storage type for a Unit's NumericType, e.g. Unit&lt;Packed&lt;std::int16_t&gt;, quantities::Length, hundredthMillimetre&gt;.
+    /// The quantisation step (and offset) is the Unit's conversion: a ratio conversion of 1e-5 stores hundredths of a
+    /// millimetre per count. Reading a Packed widens it to Compute, so any arithmetic on it is carried out in Compute
+    /// and produces Compute-valued units; only assigning back into a Packed rounds and saturates.
+    /// </summary>
+    /// <typeparam name="Stored">the stored type: a narrow integer, or a narrow float such as _Float16 where the compiler has one</typeparam>
+    /// <typeparam name="Compute">the type values are widened to for arithmetic and conversions</typeparam>
+    template<typename Stored, typename Compute = double>
+    struct Packed
+    {
+        using StoredType = Stored;
+        using ComputeType = Compute;
+
+        Stored bits{};
+
+        constexpr Packed() = default;
+        explicit constexpr Packed(const Compute& value)noexcept : bits{ quantize(value) } {}
+
+        constexpr operator Compute()const noexcept { return static_cast<Compute>(bits); }
+
+        constexpr Packed& operator+=(const Compute& x)noexcept { bits = quantize(static_cast<Compute>(bits) + x); return *this; }
+        constexpr Packed& operator-=(const Compute& x)noexcept { bits = quantize(static_cast<Compute>(bits) - x); return *this; }
+        constexpr Packed& operator*=(const Compute& x)noexcept { bits = quantize(static_cast<Compute>(bits) * x); return *this; }
+        constexpr Packed& operator/=(const Compute& x)noexcept { bits = quantize(static_cast<Compute>(bits) / x); return *this; }
+
+        //rounds to the nearest step, saturating at the limits of Stored. rounding before clamping keeps the bulk
+        //loops free of branches, so they vectorise where the target has a vector round (SSE4.1, NEON)
+        static constexpr Stored quantize(Compute x)noexcept
+        {
+            if constexpr (std::is_integral_v<Stored>)
+            {
+                constexpr Compute lo = static_cast<Compute>(std::numeric_limits<Stored>::min());
+                constexpr Compute hi = static_cast<Compute>(std::numeric_limits<Stored>::max());
+                if (std::is_constant_evaluated()) x = static_cast<Compute>(static_cast<long long>(x + (x < Compute(0) ? Compute(-0.5) : Compute(0.5))));
+                else x = std::nearbyint(x);
+                x = x < hi ? x : hi;
+                x = x > lo ? x : lo;
+                return static_cast<Stored>(x);
+            }
+            else
+            {
+                return static_cast<Stored>(x);
+            }
+        }
+    };
+
+    template<typename Stored, typename Compute>
+    struct ComputeTypeHelper<Packed<Stored, Compute>>
+    {
+        using type = Compute;
+    };
+
+    template<typename T>
+    constexpr bool b_is_packed = false;
+
+    template<typename Stored, typename Compute>
+    constexpr bool b_is_packed<Packed<Stored, Compute>> = true;
+
+    namespace quantized
+    {
+        //converts every element of in into out with one scale and offset, found once for the pair of conversions.
+        //in and out must be the same size, or this throws std::invalid_argument
+        template<typename In, typename Out>
+        void convertAll(const In& in, Out& out)
+        {
+            using From = std::ranges::range_value_t<In>;
+            using To = std::ranges::range_value_t<Out>;
+            using FromConversion = typename From::ConversionType;
+            using ToConversion = typename To::ConversionType;
+            using Compute = ComputeType<typename To::ValueType>;
+
+            static_assert(b_is_same<typename From::Quantity, typename To::Quantity>, "units must have the same quantity");
+            static_assert(LinearConversion<FromConversion> && LinearConversion<ToConversion>, "bulk conversion needs ratio or linear conversions");
+
+            const Affine<Compute> f = affine<FromConversion, ToConversion, Compute>();
+
+            const size_t n = std::ranges::size(in);
+            if (std::ranges::size(out) != n) throw std::invalid_argument("in and out must be the same size");
+            const auto* src = std::ranges::data(in);
+            auto* dst = std::ranges::data(out);
+            for (size_t i = 0; i < n; ++i)
+            {
+                dst[i] = To(static_cast<typename To::ValueType>(f(static_cast<Compute>(src[i].value()))));
+            }
+        }
+    }
+
+    //quantises a range of units into a range of Packed units of the same size, e.g. metres<double> into Unit<Packed<std::int16_t>, Length, ...>
+    template<std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+    void pack(const In& in, Out&& out)
+    {
+        static_assert(b_is_packed<typename std::ranges::range_value_t<Out>::ValueType>, "pack writes to Packed units");
+        quantized::convertAll(in, out);
+    }
+
+    //widens a range of Packed units into a range of units of any conversion, of the same size
+    template<std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+    void unpack(const In& in, Out&& out)
+    {
+        static_assert(b_is_packed<typename std::ranges::range_value_t<In>::ValueType>, "unpack reads from Packed units");
+        quantized::convertAll(in, out);
+    }
+}
+
+#endif
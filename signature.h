@@ -0,0 +1,84 @@
+#ifndef UNITS_SIGNATURE_H
+#define UNITS_SIGNATURE_H
+
+#include "quantity.h"
+#include "tags.h"
+
+#include <array>
+
+namespace units
+{
+    //the position of each standard tag in a Signature. user-defined tags have no position (-1)
+    template<typename Tag>
+    constexpr int tag_index = -1;
+
+    template<> constexpr int tag_index<tags::Length> = 0;
+    template<> constexpr int tag_index<tags::Mass> = 1;
+    template<> constexpr int tag_index<tags::Time> = 2;
+    template<> constexpr int tag_index<tags::Current> = 3;
+    template<> constexpr int tag_index<tags::Temperature> = 4;
+    template<> constexpr int tag_index<tags::Amount> = 5;
+    template<> constexpr int tag_index<tags::Luminosity> = 6;
+    template<> constexpr int tag_index<tags::Currency> = 7;
+    template<> constexpr int tag_index<tags::Angle> = 8;
+
+    constexpr size_t n_standard_tags = 9;
+
+    /// <summary>
+    /// The exponents of a quantity over the standard tags, as a runtime value. Used wherever dimensions have to be
+    /// checked against data that only exists at runtime, such as unit strings or serialised schemas.
+    /// </summary>
+    struct Signature
+    {
+        std::array<int, n_standard_tags> exponents{};
+
+        constexpr bool operator==(const Signature&)const = default;
+
+        constexpr Signature& operator*=(const Signature& other)noexcept
+        {
+            for (size_t i = 0; i < n_standard_tags; ++i) exponents[i] += other.exponents[i];
+            return *this;
+        }
+
+        constexpr Signature& operator/=(const Signature& other)noexcept
+        {
+            for (size_t i = 0; i < n_standard_tags; ++i) exponents[i] -= other.exponents[i];
+            return *this;
+        }
+
+        constexpr Signature pow(int n)const noexcept
+        {
+            Signature out = *this;
+            for (auto& e : out.exponents) e *= n;
+            return out;
+        }
+
+        constexpr bool isDimensionless()const noexcept { return *this == Signature{}; }
+    };
+
+    constexpr Signature operator*(Signature s1, const Signature& s2)noexcept { return s1 *= s2; }
+    constexpr Signature operator/(Signature s1, const Signature& s2)noexcept { return s1 /= s2; }
+
+    template<typename QuantityType>
+    struct SignatureOf;
+
+    template<typename ... Dims>
+    struct SignatureOf<Quantity<Dims...>>
+    {
+        static_assert(((tag_index<typename Dims::dimension> >= 0) && ...), "only quantities made of the standard tags have a Signature");
+
+        static constexpr Signature make()noexcept
+        {
+            Signature s;
+            ((s.exponents[tag_index<typename Dims::dimension>] += Dims::exponent), ...);
+            return s;
+        }
+
+        static constexpr Signature value = make();
+    };
+
+    template<QuantityType Q>
+    constexpr Signature signature_of = SignatureOf<Q>::value;
+}
+
+#endif
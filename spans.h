@@ -0,0 +1,61 @@
+#ifndef UNITS_SPANS_H
+#define UNITS_SPANS_H
+
+#include "unit.h"
+
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace units
+{
+    //zero-copy views between arrays of units and arrays of their raw values, for C APIs, BLAS and file buffers.
+    //the views alias the original storage, so they are only valid as long as it is, and keep its constness.
+    //temporaries that own their storage (like a returned std::vector) are rejected, as the view would dangle
+
+    namespace spans
+    {
+        template<typename R>
+        using Element = std::remove_reference_t<std::ranges::range_reference_t<R>>;
+
+        template<typename R>
+        concept UnitRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && std::ranges::borrowed_range<R>
+            && UnitType<std::remove_const_t<Element<R>>>;
+
+        template<typename R>
+        concept RawRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && std::ranges::borrowed_range<R>
+            && !UnitType<std::remove_const_t<Element<R>>>;
+
+        //copies the constness of From onto To
+        template<typename From, typename To>
+        using Constness = BoolTypePredicate<std::is_const_v<From>, To, const To>;
+    }
+
+    /// <summary>
+    /// Views an array of units, e.g. a std::vector&lt;metres&lt;double&gt;&gt;, as a std::span of their values in place
+    /// </summary>
+    template<spans::UnitRange R>
+    auto as_raw_span(R&& units)noexcept
+    {
+        using U = spans::Element<R>;
+        using N = typename std::remove_const_t<U>::ValueType;
+        static_assert(b_is_raw_layout<std::remove_const_t<U>>, "the unit's NumericType must be trivially copyable and standard layout");
+        return std::span<spans::Constness<U, N>>(reinterpret_cast<spans::Constness<U, N>*>(std::ranges::data(units)), std::ranges::size(units));
+    }
+
+    /// <summary>
+    /// Views an array of raw values, e.g. a buffer filled by a C API, as a std::span of Unit&lt;N, Q, C&gt; in place.
+    /// the values must already be in C: nothing is converted
+    /// </summary>
+    template<typename Q, typename C = NoConversion, spans::RawRange R>
+    auto as_unit_span(R&& values)noexcept
+    {
+        using T = spans::Element<R>;
+        using U = Unit<std::remove_const_t<T>, Q, C>;
+        static_assert(b_is_raw_layout<U>, "the NumericType must be trivially copyable and standard layout");
+        return std::span<spans::Constness<T, U>>(reinterpret_cast<spans::Constness<T, U>*>(std::ranges::data(values)), std::ranges::size(values));
+    }
+}
+
+#endif
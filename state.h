@@ -0,0 +1,161 @@
+#ifndef UNITS_STATE_H
+#define UNITS_STATE_H
+
+#include "conversions.h"
+#include "quantities.h"
+#include "unit.h"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+namespace units
+{
+    /// <summary>
+    /// A state vector of mixed units, e.g. StateVector&lt;metres&lt;double&gt;, Unit&lt;double, quantities::Velocity&gt;, radians&lt;double&gt;&gt;,
+    /// stored as one contiguous, aligned array of raw values so that solvers can run flat loops (or BLAS) over it.
+    /// get&lt;I&gt;() views a component as its Unit in place. Every component must share one NumericType.
+    /// </summary>
+    template<UnitType ... Units>
+    class StateVector
+    {
+    public:
+        static_assert(sizeof...(Units) > 0, "a state vector needs at least one component");
+
+        template<size_t I>
+        using Component = std::tuple_element_t<I, std::tuple<Units...>>;
+
+        using ValueType = typename Component<0>::ValueType;
+
+        static_assert((std::is_same_v<typename Units::ValueType, ValueType> && ...), "state vector components must share a NumericType");
+        static_assert((b_is_raw_layout<Units> && ...), "state vector components must have the layout of their NumericType");
+
+        //the time derivative of each component, in the component's own conversion per second
+        using Derivative = StateVector<Unit<ValueType, DivideType<typename Units::Quantity, quantities::Time>, DeltaOf<typename Units::ConversionType>>...>;
+
+        static constexpr size_t size()noexcept { return sizeof...(Units); }
+
+        constexpr StateVector()noexcept : m_values{} {}
+        explicit constexpr StateVector(const Units&... components)noexcept : m_values{ components.value()... } {}
+
+        template<size_t I>
+        Component<I>& get()noexcept { return *reinterpret_cast<Component<I>*>(&m_values[I]); }
+
+        template<size_t I>
+        const Component<I>& get()const noexcept { return *reinterpret_cast<const Component<I>*>(&m_values[I]); }
+
+        ValueType* data()noexcept { return m_values; }
+        const ValueType* data()const noexcept { return m_values; }
+
+        std::span<ValueType, sizeof...(Units)> values()noexcept { return std::span<ValueType, sizeof...(Units)>(m_values); }
+        std::span<const ValueType, sizeof...(Units)> values()const noexcept { return std::span<const ValueType, sizeof...(Units)>(m_values); }
+
+        //adds a state of differences to this, e.g. dt * derivative. each component of other must have this one's quantity,
+        //and is converted into this one's conversion by the ratio of their delta conversions
+        template<UnitType ... Others>
+        StateVector& operator+=(const StateVector<Others...>& other)noexcept;
+
+        template<UnitType ... Others>
+        StateVector& operator-=(const StateVector<Others...>& other)noexcept;
+
+        template<Scalar S>
+        StateVector& operator*=(const S& s)noexcept;
+
+    private:
+        template<UnitType ... Others>
+        static constexpr std::array<ValueType, sizeof...(Units)> factorsFrom()noexcept
+        {
+            static_assert(sizeof...(Others) == sizeof...(Units), "state vectors must have the same number of components");
+            static_assert((b_is_same<typename Others::Quantity, typename Units::Quantity> && ...),
+                "state vector components must have the same quantities, e.g. a state and dt * its Derivative");
+            return { affine<DeltaOf<typename Others::ConversionType>, DeltaOf<typename Units::ConversionType>, ValueType>().scale... };
+        }
+
+        alignas(alignof(ValueType) > 32 ? alignof(ValueType) : 32) ValueType m_values[sizeof...(Units)];
+    };
+
+    template<typename T>
+    constexpr bool b_is_state_vector = false;
+
+    template<UnitType ... Units>
+    constexpr bool b_is_state_vector<StateVector<Units...>> = true;
+
+    template<UnitType ... Units>
+    template<UnitType ... Others>
+    StateVector<Units...>& StateVector<Units...>::operator+=(const StateVector<Others...>& other)noexcept
+    {
+        constexpr std::array<ValueType, sizeof...(Units)> k = factorsFrom<Others...>();
+        const ValueType* b = other.data();
+        for (size_t i = 0; i < sizeof...(Units); ++i) m_values[i] += k[i] * b[i];
+        return *this;
+    }
+
+    template<UnitType ... Units>
+    template<UnitType ... Others>
+    StateVector<Units...>& StateVector<Units...>::operator-=(const StateVector<Others...>& other)noexcept
+    {
+        constexpr std::array<ValueType, sizeof...(Units)> k = factorsFrom<Others...>();
+        const ValueType* b = other.data();
+        for (size_t i = 0; i < sizeof...(Units); ++i) m_values[i] -= k[i] * b[i];
+        return *this;
+    }
+
+    template<UnitType ... Units>
+    template<Scalar S>
+    StateVector<Units...>& StateVector<Units...>::operator*=(const S& s)noexcept
+    {
+        for (size_t i = 0; i < sizeof...(Units); ++i) m_values[i] *= s;
+        return *this;
+    }
+
+    template<UnitType ... Units, UnitType ... Others>
+    StateVector<Units...> operator+(StateVector<Units...> state, const StateVector<Others...>& other)noexcept
+    {
+        return state += other;
+    }
+
+    template<UnitType ... Units, UnitType ... Others>
+    StateVector<Units...> operator-(StateVector<Units...> state, const StateVector<Others...>& other)noexcept
+    {
+        return state -= other;
+    }
+
+    //b_is_state_vector is checked first, so that testing whether a StateVector is a Scalar doesn't recurse into these
+    template<typename S, UnitType ... Units> requires (!b_is_state_vector<S> && Scalar<S>)
+    StateVector<Units...> operator*(const S& s, StateVector<Units...> state)noexcept
+    {
+        return state *= s;
+    }
+
+    template<typename S, UnitType ... Units> requires (!b_is_state_vector<S> && Scalar<S>)
+    StateVector<Units...> operator*(StateVector<Units...> state, const S& s)noexcept
+    {
+        return state *= s;
+    }
+
+    //scales each component by a time step, e.g. dt * derivative, giving each component's quantity times Time.
+    //the components keep their conversions, with dt's folded into the values
+    template<typename N, typename TC, UnitType ... Units>
+    StateVector<Unit<typename Units::ValueType, MultiplyType<typename Units::Quantity, quantities::Time>, typename Units::ConversionType>...>
+        operator*(const Unit<N, quantities::Time, TC>& dt, const StateVector<Units...>& derivative)noexcept
+    {
+        using Out = StateVector<Unit<typename Units::ValueType, MultiplyType<typename Units::Quantity, quantities::Time>, typename Units::ConversionType>...>;
+        using V = typename Out::ValueType;
+        const V seconds = affine<DeltaOf<TC>, NoConversion, V>().scale * static_cast<V>(dt.value());
+        Out out;
+        const V* d = derivative.data();
+        V* o = out.data();
+        for (size_t i = 0; i < Out::size(); ++i) o[i] = seconds * d[i];
+        return out;
+    }
+
+    template<typename N, typename TC, UnitType ... Units>
+    auto operator*(const StateVector<Units...>& derivative, const Unit<N, quantities::Time, TC>& dt)noexcept
+    {
+        return dt * derivative;
+    }
+}
+
+#endif
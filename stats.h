@@ -0,0 +1,402 @@
+#ifndef UNITS_STATS_H
+#define UNITS_STATS_H
+
+#include "conversions.h"
+#include "unit.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace units
+{
+    template<typename N, typename Q, typename C, typename Buckets>
+    class Recorder;
+
+    /// <summary>
+    /// Count, mean, variance (by Welford's method), min and max of a stream of samples, kept in the samples' own
+    /// conversion so that adding one costs no conversion. Accumulators from different threads or shards merge exactly.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion>
+    class Statistics
+    {
+        template<typename N2, typename Q2, typename C2, typename Buckets>
+        friend class Recorder;
+    public:
+        static_assert(std::is_floating_point_v<N>, "statistics need a floating point NumericType");
+
+        using Sample = Unit<N, Q, C>;
+        //the variance is in the standard unit of Q squared, as a squared conversion has no conversion of its own
+        using Variance = Unit<N, MultiplyType<Q, Q>, NoConversion>;
+        //the standard deviation is a difference between samples, so it's in C's delta conversion
+        using Deviation = Unit<N, Q, DeltaOf<C>>;
+
+        constexpr void add(const Sample& sample)noexcept
+        {
+            const N x = sample.value();
+            ++m_count;
+            const N delta = x - m_mean;
+            m_mean += delta / static_cast<N>(m_count);
+            m_m2 += delta * (x - m_mean);
+            m_min = x < m_min ? x : m_min;
+            m_max = x > m_max ? x : m_max;
+        }
+
+        //combines the moments of other into this (Chan et al.), as if other's samples had been added here
+        constexpr Statistics& merge(const Statistics& other)noexcept;
+
+        constexpr std::uint64_t count()const noexcept { return m_count; }
+        constexpr Sample mean()const noexcept { return Sample(m_mean); }
+        constexpr Sample min()const noexcept { return Sample(m_min); }
+        constexpr Sample max()const noexcept { return Sample(m_max); }
+
+        //the sample variance, with Bessel's correction. 0 for fewer than two samples
+        constexpr Variance variance()const noexcept
+        {
+            constexpr N g = affine<DeltaOf<C>, NoConversion, N>().scale;
+            return Variance(m_count > 1 ? m_m2 / static_cast<N>(m_count - 1) * (g * g) : N(0));
+        }
+
+        Deviation standardDeviation()const noexcept
+        {
+            return Deviation(m_count > 1 ? std::sqrt(m_m2 / static_cast<N>(m_count - 1)) : N(0));
+        }
+
+    private:
+        std::uint64_t m_count = 0;
+        N m_mean{};
+        N m_m2{};
+        N m_min = std::numeric_limits<N>::infinity();
+        N m_max = -std::numeric_limits<N>::infinity();
+    };
+
+    template<typename N, typename Q, typename C>
+    constexpr Statistics<N, Q, C>& Statistics<N, Q, C>::merge(const Statistics& other)noexcept
+    {
+        if (other.m_count == 0) return *this;
+        if (m_count == 0) return *this = other;
+
+        const N n1 = static_cast<N>(m_count);
+        const N n2 = static_cast<N>(other.m_count);
+        const N n = n1 + n2;
+        const N delta = other.m_mean - m_mean;
+        m_mean += delta * (n2 / n);
+        m_m2 += other.m_m2 + delta * delta * (n1 * n2 / n);
+        m_count += other.m_count;
+        m_min = other.m_min < m_min ? other.m_min : m_min;
+        m_max = other.m_max > m_max ? other.m_max : m_max;
+        return *this;
+    }
+
+    //for recorders that keep no histogram
+    template<typename N, typename Q, typename C = NoConversion>
+    struct NoBuckets
+    {
+        using Sample = Unit<N, Q, C>;
+
+        static constexpr size_t size()noexcept { return 0; }
+        static constexpr size_t index(const Sample&)noexcept { return 0; }
+    };
+
+    /// <summary>
+    /// Evenly spaced buckets between two bounds in the samples' own conversion, with one more bucket at each end for
+    /// samples below and above them. Bucket i + 1 holds [lower + i * width, lower + (i + 1) * width).
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion>
+    class LinearBuckets
+    {
+    public:
+        using Sample = Unit<N, Q, C>;
+
+        LinearBuckets(const Sample& lower, const Sample& upper, size_t count) :
+            m_lower{ lower.value() }, m_inverseWidth{ static_cast<N>(count) / (upper.value() - lower.value()) }, m_count{ count } {}
+
+        size_t size()const noexcept { return m_count + 2; }
+
+        size_t index(const Sample& sample)const noexcept
+        {
+            N f = (sample.value() - m_lower) * m_inverseWidth + N(1);
+            f = f > N(0) ? f : N(0);
+            f = f < N(m_count + 1) ? f : N(m_count + 1);
+            return static_cast<size_t>(f);
+        }
+
+        //the lowest sample bucket i holds. the underflow bucket has no lower bound, so gives -infinity
+        Sample lowerBound(size_t i)const noexcept
+        {
+            return Sample(i == 0 ? -std::numeric_limits<N>::infinity() : m_lower + static_cast<N>(i - 1) / m_inverseWidth);
+        }
+
+    private:
+        N m_lower;
+        N m_inverseWidth;
+        size_t m_count;
+    };
+
+    /// <summary>
+    /// HDR-style logarithmic buckets, for samples such as latencies that span many orders of magnitude. Each doubling
+    /// above lowest is split into subBuckets evenly spaced buckets, so the relative error of any bucket is at most
+    /// 1 / subBuckets. The index comes from the sample's binary exponent and mantissa, without calling log.
+    /// Samples below lowest go in bucket 0, and above highest in the last bucket.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion>
+    class LogBuckets
+    {
+    public:
+        using Sample = Unit<N, Q, C>;
+
+        LogBuckets(const Sample& lowest, const Sample& highest, size_t subBuckets) :
+            m_lowest{ lowest.value() }, m_inverseLowest{ N(1) / lowest.value() }, m_subBuckets{ subBuckets },
+            m_octaves{ static_cast<size_t>(std::ceil(std::log2(highest.value() / lowest.value()))) } {}
+
+        size_t size()const noexcept { return m_octaves * m_subBuckets + 2; }
+
+        size_t index(const Sample& sample)const noexcept
+        {
+            const N x = sample.value() * m_inverseLowest;
+            if (!(x >= N(1))) return 0;
+            int e;
+            const N m = std::frexp(x, &e);
+            const size_t i = static_cast<size_t>(e - 1) * m_subBuckets + static_cast<size_t>((N(2) * m - N(1)) * static_cast<N>(m_subBuckets)) + 1;
+            return i < size() - 1 ? i : size() - 1;
+        }
+
+        Sample lowerBound(size_t i)const noexcept
+        {
+            if (i == 0) return Sample(-std::numeric_limits<N>::infinity());
+            const size_t octave = (i - 1) / m_subBuckets;
+            const size_t sub = (i - 1) % m_subBuckets;
+            return Sample(m_lowest * std::ldexp(N(1) + static_cast<N>(sub) / static_cast<N>(m_subBuckets), static_cast<int>(octave)));
+        }
+
+    private:
+        N m_lowest;
+        N m_inverseLowest;
+        size_t m_subBuckets;
+        size_t m_octaves;
+    };
+
+    /// <summary>
+    /// Counts of samples per bucket, for LinearBuckets or LogBuckets.
+    /// </summary>
+    template<typename Buckets>
+    class Histogram
+    {
+    public:
+        using Sample = typename Buckets::Sample;
+
+        explicit Histogram(const Buckets& buckets) : m_buckets{ buckets }, m_counts(buckets.size()) {}
+        Histogram(const Buckets& buckets, std::vector<std::uint64_t> counts) : m_buckets{ buckets }, m_counts{ std::move(counts) } {}
+
+        void add(const Sample& sample)noexcept { ++m_counts[m_buckets.index(sample)]; }
+
+        //adds other's counts to this. both must have been made with the same buckets
+        Histogram& merge(const Histogram& other)noexcept
+        {
+            for (size_t i = 0; i < m_counts.size(); ++i) m_counts[i] += other.m_counts[i];
+            return *this;
+        }
+
+        size_t size()const noexcept { return m_counts.size(); }
+        std::uint64_t count(size_t i)const noexcept { return m_counts[i]; }
+        Sample lowerBound(size_t i)const noexcept { return m_buckets.lowerBound(i); }
+        const Buckets& buckets()const noexcept { return m_buckets; }
+
+        //the lower bound of the bucket holding the q-th quantile, e.g. 0.99 for the 99th percentile
+        Sample quantile(double q)const noexcept;
+
+    private:
+        Buckets m_buckets;
+        std::vector<std::uint64_t> m_counts;
+    };
+
+    template<typename Buckets>
+    typename Histogram<Buckets>::Sample Histogram<Buckets>::quantile(double q)const noexcept
+    {
+        std::uint64_t total = 0;
+        for (std::uint64_t c : m_counts) total += c;
+        const std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total));
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < m_counts.size(); ++i)
+        {
+            seen += m_counts[i];
+            if (seen > rank) return lowerBound(i);
+        }
+        return lowerBound(m_counts.size() - 1);
+    }
+
+    /// <summary>
+    /// One thread's statistics (and histogram), readable from other threads while it records. Only the owning thread
+    /// may call add(), which is wait-free: it publishes the new moments under a sequence lock that never makes the
+    /// writer wait. Readers retry if they overlap a write, so a snapshot is always of a consistent set of samples.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, typename Buckets = NoBuckets<N, Q, C>>
+    class Recorder
+    {
+    public:
+        using Sample = Unit<N, Q, C>;
+        using StatisticsType = Statistics<N, Q, C>;
+
+        static_assert(std::is_same_v<typename Buckets::Sample, Sample>, "buckets must be for the recorder's Unit");
+
+        explicit Recorder(const Buckets& buckets = {}) : m_buckets{ buckets }, m_counts(buckets.size()) {}
+
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        void add(const Sample& sample)noexcept;
+
+        //a consistent copy of the statistics so far. histogram counts are added into counts, which must have size() entries
+        StatisticsType read(std::uint64_t* counts = nullptr)const noexcept;
+
+        size_t size()const noexcept { return m_counts.size(); }
+
+    private:
+        template<typename N2, typename Q2, typename C2, typename B2>
+        friend class StatisticsRegistry;
+
+        //the writer's own copy, which only it touches
+        StatisticsType m_local;
+        Buckets m_buckets;
+
+        //the published copy, read by other threads
+        std::atomic<std::uint64_t> m_sequence{ 0 };
+        std::atomic<std::uint64_t> m_count{ 0 };
+        std::atomic<N> m_mean{};
+        std::atomic<N> m_m2{};
+        std::atomic<N> m_min{ std::numeric_limits<N>::infinity() };
+        std::atomic<N> m_max{ -std::numeric_limits<N>::infinity() };
+        std::vector<std::atomic<std::uint64_t>> m_counts;
+
+        Recorder* m_next = nullptr;
+    };
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    void Recorder<N, Q, C, Buckets>::add(const Sample& sample)noexcept
+    {
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_local.add(sample);
+        m_count.store(m_local.m_count, std::memory_order_relaxed);
+        m_mean.store(m_local.m_mean, std::memory_order_relaxed);
+        m_m2.store(m_local.m_m2, std::memory_order_relaxed);
+        m_min.store(m_local.m_min, std::memory_order_relaxed);
+        m_max.store(m_local.m_max, std::memory_order_relaxed);
+        if constexpr (!std::is_same_v<Buckets, NoBuckets<N, Q, C>>)
+        {
+            //the only writer, so no read-modify-write is needed
+            std::atomic<std::uint64_t>& bucket = m_counts[m_buckets.index(sample)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    typename Recorder<N, Q, C, Buckets>::StatisticsType Recorder<N, Q, C, Buckets>::read(std::uint64_t* counts)const noexcept
+    {
+        StatisticsType out;
+        std::vector<std::uint64_t> copy(counts ? m_counts.size() : 0);
+        for (;;)
+        {
+            const std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            out.m_count = m_count.load(std::memory_order_relaxed);
+            out.m_mean = m_mean.load(std::memory_order_relaxed);
+            out.m_m2 = m_m2.load(std::memory_order_relaxed);
+            out.m_min = m_min.load(std::memory_order_relaxed);
+            out.m_max = m_max.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < copy.size(); ++i) copy[i] = m_counts[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) break;
+        }
+        for (size_t i = 0; i < copy.size(); ++i) counts[i] += copy[i];
+        return out;
+    }
+
+    /// <summary>
+    /// Hands out a Recorder per thread and merges them all into one snapshot. Recorders are kept in a list which is
+    /// only ever pushed onto (with a compare-and-swap), so neither registering nor snapshotting takes a lock.
+    /// Recorders live until the registry is destroyed.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, typename Buckets = NoBuckets<N, Q, C>>
+    class StatisticsRegistry
+    {
+    public:
+        using RecorderType = Recorder<N, Q, C, Buckets>;
+        using StatisticsType = Statistics<N, Q, C>;
+
+        struct Snapshot
+        {
+            StatisticsType statistics;
+            std::vector<std::uint64_t> counts;
+        };
+
+        explicit StatisticsRegistry(const Buckets& buckets = {}) : m_buckets{ buckets } {}
+        ~StatisticsRegistry();
+
+        StatisticsRegistry(const StatisticsRegistry&) = delete;
+        StatisticsRegistry& operator=(const StatisticsRegistry&) = delete;
+
+        //a new recorder, for one thread to keep and record into
+        RecorderType& recorder();
+
+        Snapshot snapshot()const;
+
+        //the snapshot's counts as a Histogram, with the registry's buckets
+        Histogram<Buckets> histogram(const Snapshot& snapshot)const;
+
+    private:
+        Buckets m_buckets;
+        std::atomic<RecorderType*> m_head{ nullptr };
+    };
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    StatisticsRegistry<N, Q, C, Buckets>::~StatisticsRegistry()
+    {
+        RecorderType* r = m_head.load(std::memory_order_acquire);
+        while (r)
+        {
+            RecorderType* next = r->m_next;
+            delete r;
+            r = next;
+        }
+    }
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    typename StatisticsRegistry<N, Q, C, Buckets>::RecorderType& StatisticsRegistry<N, Q, C, Buckets>::recorder()
+    {
+        RecorderType* r = new RecorderType(m_buckets);
+        r->m_next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(r->m_next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        return *r;
+    }
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    typename StatisticsRegistry<N, Q, C, Buckets>::Snapshot StatisticsRegistry<N, Q, C, Buckets>::snapshot()const
+    {
+        Snapshot out;
+        out.counts.resize(m_buckets.size());
+        for (const RecorderType* r = m_head.load(std::memory_order_acquire); r; r = r->m_next)
+        {
+            out.statistics.merge(r->read(out.counts.data()));
+        }
+        return out;
+    }
+
+    template<typename N, typename Q, typename C, typename Buckets>
+    Histogram<Buckets> StatisticsRegistry<N, Q, C, Buckets>::histogram(const Snapshot& snapshot)const
+    {
+        return Histogram<Buckets>(m_buckets, snapshot.counts);
+    }
+}
+
+#endif
@@ -1,11 +1,24 @@
+#include "calculus.h"
 #include "conversions.h"
+#include "ingest.h"
+#include "lookup.h"
+#include "names.h"
 #include "quantities.h"
 #include "quantity.h"
+#include "quantized.h"
+#include "spans.h"
+#include "state.h"
+#include "stats.h"
 #include "unit.h"
 #include "units.h"
 #include "util.h"
+#include "vector.h"
+#include "wire.h"
 
+#include <cmath>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 struct MyStruct
 {
@@ -19,8 +32,37 @@ struct Mass {};
 
 CREATE_RATIO_CONVERSION(MilliConversion, 0.001)
 CREATE_RATIO_CONVERSION(KiloConversion, 1000)
+CREATE_RATIO_CONVERSION(HundredthMillimetre, 1e-5)
+
+struct Reading
+{
+    units::metres<double> position;
+    units::Unit<double, units::quantities::Velocity> speed;
+};
+
+struct CoarseReading
+{
+    units::millimetres<float> position;
+    units::Unit<float, units::quantities::Velocity, units::conversions::kilo> speed;
+};
+
+CREATE_WIRE_RECORD(Reading, &Reading::position, &Reading::speed)
+CREATE_WIRE_RECORD(CoarseReading, &CoarseReading::position, &CoarseReading::speed)
 
 #define PRINT_EXPR(...) std::cout << "Expression '" #__VA_ARGS__ "': " << (__VA_ARGS__) << '\n';
+//for checking that an expression is rejected
+template<typename A, typename B>
+concept CanAdd = requires(A a, B b) { a + b; };
+
+template<typename A, typename B>
+concept CanAddAssign = requires(A a, B b) { a += b; };
+
+template<typename A, typename B>
+concept CanSubtractAssign = requires(A a, B b) { a -= b; };
+
+template<typename R>
+concept CanViewRaw = requires(R&& r) { units::as_raw_span(std::forward<R>(r)); };
+
 #define PRINT_TYPE_NAME(obj) std::cout << "TYPE OF (" #obj "): " << typeid(decltype(obj)).name() << '\n';
 
 
@@ -98,5 +140,275 @@ int main()
 
      units::kilonewtons<double> someForce;
 
+    //streaming ingest: units from the header and from the cells
+    std::istringstream csv(
+        "id,distance[km],speed,duration\n"
+        "1,1.5,10 m/s,\"2 min\"\n"
+        "2,0.25,36 km/h,30 s\n");
+    units::TableReader<units::metres<double>, units::Unit<double, units::quantities::Velocity>, units::seconds<double>>
+        reader({ "distance", "speed", "duration" }, { .chunkBytes = 16, .threads = 2 });
+    auto [distances, speeds, durations] = reader.readAll(csv);
+    PRINT_EXPR(distances.size());
+    PRINT_EXPR(distances[0].value());
+    PRINT_EXPR(speeds[1].value());
+    PRINT_EXPR(durations[0].value());
+    PRINT_EXPR(units::parseUnit("kg\xC2\xB7m\xC2\xB2\xC2\xB7s\xE2\x81\xBB\xC2\xB2")->signature == units::signature_of<units::quantities::Energy>);
+    std::istringstream sensors(
+        "time,temp[\xC2\xB0" "C]\n"
+        "0,21.5\n"
+        "1,68 degF\n"
+        "2,300 K\n");
+    units::TableReader<units::seconds<double>, units::degreesCelsius<double>> sensorReader({ "time", "temp" }, { .chunkBytes = 8, .threads = 3 });
+    auto [times, temps] = sensorReader.readAll(sensors);
+    PRINT_EXPR(temps[0].value());
+    PRINT_EXPR(temps[1].value());
+    PRINT_EXPR(temps[2].value());
+    PRINT_EXPR(units::parseUnit("\xC2\xB0" "C/s").has_value());
+    //integral columns round, and can't hold an empty cell
+    std::istringstream laps("lap,time\n1,1.5 min\n2,59.6\n");
+    units::TableReader<units::seconds<int>> lapReader({ "time" });
+    auto [lapTimes] = lapReader.readAll(laps);
+    PRINT_EXPR(lapTimes[1].value());
+    std::istringstream missingLap("lap,time\n1,\n");
+    bool emptyIntegral = false;
+    try { lapReader.readAll(missingLap); }
+    catch (const units::IngestError&) { emptyIntegral = true; }
+    PRINT_EXPR(emptyIntegral);
+
+
+    //calculus over time series
+    std::vector<units::milliseconds<double>> sampleTimes{ units::milliseconds<double>(0), units::milliseconds<double>(500), units::milliseconds<double>(1000) };
+    std::vector<units::Unit<double, units::quantities::Velocity, units::conversions::kilo>> velocities(3, units::Unit<double, units::quantities::Velocity, units::conversions::kilo>(2));
+    auto travelled = units::integrate(velocities, sampleTimes);
+    PRINT_EXPR(units::b_is_same<decltype(travelled)::value_type::Quantity, units::quantities::Length>);
+    PRINT_EXPR(travelled.back().value());
+    auto rates = units::differentiate(travelled, sampleTimes);
+    PRINT_EXPR(units::b_is_same<decltype(rates)::value_type::Quantity, units::quantities::Velocity>);
+    PRINT_EXPR(rates.back().value());
+
+    units::Resampler<double, units::quantities::Velocity, units::conversions::kilo, units::conversions::milli> resampler(units::milliseconds<double>(0), units::milliseconds<double>(250));
+    std::vector<units::Unit<double, units::quantities::Velocity, units::conversions::kilo>> resampled;
+    PRINT_EXPR(resampler.process(velocities, sampleTimes, resampled));
+    bool mismatched = false;
+    try { units::integrate(velocities, std::vector<units::milliseconds<double>>(2)); }
+    catch (const std::invalid_argument&) { mismatched = true; }
+    PRINT_EXPR(mismatched);
+
+    //affine points and deltas
+    units::degreesCelsius<double> morning(12.5), noon(20.0);
+    auto warming = noon - morning;
+    PRINT_EXPR(units::b_is_same<decltype(warming), units::degreesCelsiusDelta<double>>);
+    PRINT_EXPR(warming.value());
+    PRINT_EXPR((morning + warming).value());
+    units::degreesFahrenheitDelta<double> fWarming(9.0);
+    PRINT_EXPR((morning + fWarming).value());
+    morning += fWarming;
+    PRINT_EXPR(morning.value());
+    PRINT_EXPR(CanAdd<units::degreesCelsius<double>, units::degreesCelsius<double>>);
+    PRINT_EXPR(CanAdd<units::degreesCelsius<double>, units::degreesFahrenheit<double>>);
+    PRINT_EXPR(CanAddAssign<units::degreesCelsius<double>, units::degreesCelsius<double>>);
+    PRINT_EXPR(CanAdd<units::degreesCelsiusDelta<double>, units::degreesCelsiusDelta<double>>);
+    PRINT_EXPR(CanSubtractAssign<units::degreesCelsius<double>, units::degreesCelsius<double>>);
+    PRINT_EXPR(CanSubtractAssign<units::degreesCelsius<double>, units::degreesFahrenheit<double>>);
+    PRINT_EXPR(CanSubtractAssign<units::degreesCelsius<double>, units::degreesFahrenheitDelta<double>>);
+    PRINT_EXPR(std::is_convertible_v<units::degreesCelsiusDelta<double>, units::degreesCelsius<double>>);
+    PRINT_EXPR(std::is_convertible_v<units::degreesCelsius<double>, units::degreesCelsiusDelta<double>>);
+    PRINT_EXPR(std::is_assignable_v<units::degreesCelsiusDelta<double>&, units::degreesFahrenheit<double>>);
+    PRINT_EXPR(std::is_convertible_v<units::degreesCelsiusDelta<double>, units::degreesFahrenheitDelta<double>>);
+    //kelvins aren't a delta against Celsius: both sides go through the standard unit
+    PRINT_EXPR((units::degreesCelsius<double>(20) - units::kelvins<double>(300)).value());
+    PRINT_EXPR((units::kelvins<double>(300) - units::degreesCelsius<double>(20)).value());
+
+    //quantised storage
+    using PackedLength = units::Unit<units::Packed<std::int16_t>, units::quantities::Length, HundredthMillimetre>;
+    PRINT_EXPR(sizeof(PackedLength));
+    std::vector<units::millimetres<double>> readings{ units::millimetres<double>(1.234), units::millimetres<double>(-0.5), units::millimetres<double>(1000) };
+    std::vector<PackedLength> packed(readings.size());
+    units::pack(readings, packed);
+    PRINT_EXPR(packed[0].value().bits);
+    PRINT_EXPR(packed[2].value().bits);
+    auto packedSum = packed[0] + packed[1];
+    PRINT_TYPE_NAME(packedSum.value());
+    PRINT_EXPR(packedSum.toUnit<units::conversions::milli>().value());
+    std::vector<units::millimetres<double>> unpacked(packed.size());
+    units::unpack(packed, unpacked);
+    PRINT_EXPR(unpacked[1].value());
+    bool truncated = false;
+    try { units::unpack(packed, std::vector<units::millimetres<double>>(2)); }
+    catch (const std::invalid_argument&) { truncated = true; }
+    PRINT_EXPR(truncated);
+#ifdef __FLT16_MAX__
+    using HalfLength = units::Unit<units::Packed<_Float16>, units::quantities::Length, units::conversions::milli>;
+    PRINT_EXPR(sizeof(HalfLength));
+    std::vector<HalfLength> halves(readings.size());
+    units::pack(readings, halves);
+    PRINT_EXPR(static_cast<double>(halves[0].value()));
+    units::unpack(halves, unpacked);
+    PRINT_EXPR(unpacked[2].value());
+#endif
+
+    //compile-time names
+    PRINT_EXPR(units::quantity_symbol<units::quantities::Energy>.c_str());
+    PRINT_EXPR(units::quantity_name<units::quantities::Energy>.c_str());
+    PRINT_EXPR(units::dimension_symbol<units::Dimension<units::tags::Time, -2>>.c_str());
+    PRINT_EXPR(units::unit_symbol<units::kilometres<double>>.c_str());
+    PRINT_EXPR(units::unit_symbol<units::degreesCelsius<double>>.c_str());
+    PRINT_EXPR(units::unit_symbol<PackedLength>.c_str());
+    static_assert(units::quantity_symbol<units::quantities::Velocity>.view() == "m\xC2\xB7s\xE2\x81\xBB\xC2\xB9");
+    static_assert(units::unit_symbol<units::kilograms<double>>.view() == "kg");
+    static_assert(units::unit_symbol<units::Unit<double, units::quantities::Mass, units::conversions::milli>>.view() == "g");
+    static_assert(units::unit_symbol<units::Unit<double, units::quantities::Mass, units::conversions::kilo>>.view() == "Mg");
+    static_assert(units::unit_symbol<units::Unit<double, units::quantities::Mass, units::conversions::micro>>.view() == "mg");
+    PRINT_EXPR(units::unit_symbol<units::Unit<double, units::quantities::Density, units::conversions::milli>>.c_str());
+
+
+    //lookup tables
+    using Density = units::Unit<double, units::quantities::Density>;
+    using Pressure = units::Unit<double, units::quantities::Pressure>;
+    std::vector<units::kelvins<double>> tableTemperatures{ units::kelvins<double>(273.15), units::kelvins<double>(293.15), units::kelvins<double>(313.15), units::kelvins<double>(333.15) };
+    std::vector<Density> waterDensities{ Density(999.8), Density(998.2), Density(992.2), Density(983.2) };
+    units::LookupTable<units::kelvins<double>, Density> water(tableTemperatures, waterDensities);
+    PRINT_EXPR(water(units::degreesCelsius<double>(30)).value());
+    std::vector<units::degreesCelsius<double>> queries{ units::degreesCelsius<double>(-10), units::degreesCelsius<double>(10), units::degreesCelsius<double>(55) };
+    std::vector<Density> densities(queries.size());
+    water.evaluate(queries, densities);
+    PRINT_EXPR(densities[0].value());
+    PRINT_EXPR(densities[2].value());
+    std::vector<Pressure> tablePressures{ Pressure(1e5), Pressure(2e5), Pressure(5e5) };
+    std::vector<Density> airDensities{ Density(1.275), Density(2.551), Density(6.377), Density(1.188), Density(2.376), Density(5.940),
+        Density(1.112), Density(2.224), Density(5.560), Density(1.045), Density(2.090), Density(5.226) };
+    units::LookupTable2D<units::kelvins<double>, Pressure, Density> air(tableTemperatures, tablePressures, airDensities);
+    PRINT_EXPR(air(units::degreesCelsius<double>(10), Pressure(3.5e5)).value());
+    //the axis keeps its own numeric type when the values are integers
+    std::vector<units::metres<double>> marks{ units::metres<double>(0), units::metres<double>(0.25), units::metres<double>(0.6) };
+    std::vector<units::seconds<int>> splits{ units::seconds<int>(0), units::seconds<int>(10), units::seconds<int>(24) };
+    units::LookupTable<units::metres<double>, units::seconds<int>> pace(marks, splits);
+    PRINT_EXPR(pace(units::metres<double>(0.5)).value());
+    std::vector<units::seconds<int>> tooShort(1);
+    bool mismatchedQueries = false;
+    try { pace.evaluate(marks, tooShort); }
+    catch (const std::invalid_argument&) { mismatchedQueries = true; }
+    PRINT_EXPR(mismatchedQueries);
+
+
+    //state vectors
+    using State = units::StateVector<units::kilometres<double>, units::Unit<double, units::quantities::Velocity>, units::degreesCelsius<double>>;
+    State state(units::kilometres<double>(1.5), units::Unit<double, units::quantities::Velocity>(20), units::degreesCelsius<double>(15));
+    State::Derivative derivative(units::Unit<double, units::quantities::Velocity, units::conversions::kilo>(0.02), units::Unit<double, units::quantities::Acceleration>(-2), units::Unit<double, units::quantities::Temperature, units::conversions::celsius::Delta>(0.5) / units::seconds<double>(1));
+    state += units::milliseconds<double>(500) * derivative;
+    PRINT_EXPR(state.get<0>().value());
+    PRINT_EXPR(state.get<1>().value());
+    PRINT_EXPR(state.get<2>().value());
+    PRINT_EXPR(alignof(State));
+
+
+    //wire encoding
+    std::vector<Reading> sent{ { units::metres<double>(1.5), units::Unit<double, units::quantities::Velocity>(12) }, { units::metres<double>(-0.25), units::Unit<double, units::quantities::Velocity>(30) } };
+    std::vector<std::byte> stream;
+    units::RecordWriter<Reading> writer;
+    writer.writeSchema(stream);
+    writer.write(sent, stream);
+    PRINT_EXPR(stream.size());
+    units::RecordReader<Reading> sameReader;
+    std::vector<Reading> received;
+    size_t consumed = sameReader.readSchema(stream);
+    sameReader.read(std::span<const std::byte>(stream).subspan(consumed), received);
+    PRINT_EXPR(sameReader.isBulk());
+    PRINT_EXPR(received[1].position.value());
+    units::RecordReader<CoarseReading> coarseReader;
+    std::vector<CoarseReading> coarse;
+    consumed = coarseReader.readSchema(stream);
+    coarseReader.read(std::span<const std::byte>(stream).subspan(consumed), coarse);
+    PRINT_EXPR(coarseReader.isBulk());
+    PRINT_EXPR(coarse[0].position.value());
+    PRINT_EXPR(coarse[1].speed.value());
+    //a 2 byte float is rejected with the schema, not on every read
+    std::vector<std::byte> halfStream = stream;
+    halfStream[units::wire::header_bytes + units::n_standard_tags + 1] = std::byte{ 2 };
+    bool unsupported = false;
+    try { units::RecordReader<Reading>().readSchema(halfStream); }
+    catch (const units::WireError&) { unsupported = true; }
+    PRINT_EXPR(unsupported);
+
+
+    //dimensionless results
+    double strain = units::millimetres<double>(3) / units::metres<double>(1.5);
+    PRINT_EXPR(strain);
+    PRINT_EXPR(std::exp(units::Unit<double, units::quantities::Frequency>(2) * units::seconds<double>(-0.5)));
+    PRINT_EXPR(units::b_is_dimensionless<units::quantities::Strain>);
+    PRINT_EXPR(units::b_is_dimensionless<units::quantities::Angle>);
+
+
+    //statistics
+    units::Statistics<double, units::quantities::Time, units::conversions::milli> latency, moreLatency;
+    for (double ms : { 1.0, 2.0, 3.0 }) latency.add(units::milliseconds<double>(ms));
+    for (double ms : { 4.0, 10.0 }) moreLatency.add(units::milliseconds<double>(ms));
+    latency.merge(moreLatency);
+    PRINT_EXPR(latency.mean().value());
+    PRINT_EXPR(latency.standardDeviation().value());
+    PRINT_EXPR(latency.variance().value());
+    PRINT_EXPR(latency.max().value());
+    using LatencyBuckets = units::LogBuckets<double, units::quantities::Time, units::conversions::milli>;
+    units::StatisticsRegistry<double, units::quantities::Time, units::conversions::milli, LatencyBuckets> registry(LatencyBuckets(units::milliseconds<double>(0.1), units::milliseconds<double>(1000), 4));
+    std::vector<std::thread> recorders;
+    for (int t = 0; t < 4; ++t)
+    {
+        recorders.emplace_back([&registry, t]
+        {
+            auto& recorder = registry.recorder();
+            for (int i = 0; i < 1000; ++i) recorder.add(units::milliseconds<double>(0.5 + t + (i % 10)));
+        });
+    }
+    for (auto& thread : recorders) thread.join();
+    auto snapshot = registry.snapshot();
+    PRINT_EXPR(snapshot.statistics.count());
+    PRINT_EXPR(snapshot.statistics.mean().value());
+    PRINT_EXPR(registry.histogram(snapshot).quantile(0.5).value());
+
+
+    //unit vectors
+    using ForceVec = units::UnitVec3<double, units::quantities::Force>;
+    using LengthVec = units::UnitVec3<double, units::quantities::Length, units::conversions::milli>;
+    ForceVec force(0.0, 10.0, 0.0);
+    LengthVec arm(500.0, 0.0, 0.0);
+    auto work = units::dot(force, LengthVec(0.0, 200.0, 0.0));
+    PRINT_EXPR(units::b_is_same<decltype(work)::Quantity, units::quantities::Energy>);
+    PRINT_EXPR(work.value());
+    auto torque = units::cross(arm, force);
+    PRINT_EXPR(units::b_is_same<decltype(torque)::Quantity, units::quantities::Energy>);
+    PRINT_EXPR(torque[2].value());
+    units::UnitVec3<double, units::quantities::Velocity> velocity(3.0, 4.0, 0.0);
+    PRINT_EXPR(units::norm(velocity).value());
+    PRINT_EXPR(units::normalize(velocity)[0].value());
+    PRINT_EXPR(units::dot(units::normalize(velocity), units::normalize(velocity)));
+    PRINT_EXPR(sizeof(LengthVec));
+    using LengthVec5 = units::UnitVec<double, units::quantities::Length, units::NoConversion, 5>;
+    PRINT_EXPR(LengthVec5::lanes);
+    PRINT_EXPR(units::norm(LengthVec5(3.0, 4.0, 0.0, 0.0, 12.0)).value());
+    std::vector<LengthVec> arms{ arm, LengthVec(1.0, 2.0, 3.0) };
+    std::vector<units::millimetres<double>> xs(2), ys(2), zs(2);
+    units::toComponents(arms, xs, ys, zs);
+    PRINT_EXPR(zs[1].value());
+    xs[1] = units::millimetres<double>(7.0);
+    units::fromComponents(arms, xs, ys, zs);
+    PRINT_EXPR(arms[1][0].value());
+    PRINT_EXPR(units::b_is_same<decltype(units::norm(velocity))::Quantity, units::quantities::Speed>);
+
+
+    //raw spans
+    PRINT_EXPR(units::b_is_raw_layout<units::degreesCelsius<double>>);
+    std::vector<units::millimetres<double>> lengths{ units::millimetres<double>(1.5), units::millimetres<double>(2.5) };
+    std::span<double> raw = units::as_raw_span(lengths);
+    raw[1] *= 2.0;
+    PRINT_EXPR(lengths[1].value());
+    const std::vector<float> buffer{ 20.0f, 30.0f };
+    auto temperatures = units::as_unit_span<units::quantities::Temperature, units::conversions::celsius>(buffer);
+    PRINT_EXPR(units::b_is_same<decltype(temperatures)::element_type, const units::degreesCelsius<float>>);
+    PRINT_EXPR(temperatures[1].toUnscaled().value());
+    PRINT_EXPR(units::as_raw_span(temperatures).data() == buffer.data());
+    PRINT_EXPR(CanViewRaw<std::vector<units::millimetres<double>>&>);
+    PRINT_EXPR(CanViewRaw<std::vector<units::millimetres<double>>>);
+    PRINT_EXPR(CanViewRaw<std::span<units::millimetres<double>>>);
+
     return 0;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef UNITS_UNIT_H
 #define UNITS_UNIT_H
 #include "conversions.h"
+#include "quantity.h"
+
+#include <type_traits>
 
 namespace units
 {
@@ -19,6 +22,7 @@ namespace units
     public:
         using ValueType = NumericType;
         using Quantity = QuantityType;
+        using ConversionType = ConversionImpl;
 
         constexpr Unit()noexcept(noexcept(ValueType())) :m_value{} {}
         explicit constexpr Unit(const ValueType& t)noexcept(noexcept(ValueType{ t })) :m_value{ t } {}
@@ -26,7 +30,9 @@ namespace units
         constexpr Unit(const Unit&) = default;
         constexpr Unit(Unit&&) = default;
 
+        //a point and a delta don't convert into each other: the offset would be added to or dropped from the value
         template<typename U, typename OtherConversionImpl>
+            requires (!b_is_point_and_delta<ConversionImpl, OtherConversionImpl>)
         constexpr Unit(const Unit<U, Quantity, OtherConversionImpl>& unit);
 
         ~Unit() = default;
@@ -35,21 +41,32 @@ namespace units
         constexpr explicit operator const ValueType& ()noexcept { return m_value; }
         constexpr explicit operator bool()noexcept { return m_value; }
 
+        //a dimensionless unit is a plain number, in its standard unit (so a percentage of 50 reads as 0.5)
+        constexpr operator ComputeType<ValueType>()const noexcept requires b_is_dimensionless<Quantity>
+        {
+            return ConversionImpl::unitToStandard(static_cast<ComputeType<ValueType>>(m_value));
+        }
+
         constexpr Unit& operator=(const ValueType& new_val)noexcept(noexcept(m_value = new_val)) { m_value = new_val; return *this; }
         constexpr Unit& operator=(ValueType&& new_val)noexcept { m_value = new_val; return *this; }
         constexpr Unit& operator=(Unit&&)noexcept = default;
         constexpr Unit& operator=(const Unit&) = default;
 
         template<typename U, typename OtherConversion>
+            requires (!b_is_point_and_delta<ConversionImpl, OtherConversion>)
         constexpr Unit& operator=(const Unit<U, Quantity, OtherConversion>& unit);
 
         constexpr Unit& operator+()noexcept { return *this; }
         constexpr Unit& operator-()noexcept(noexcept(-m_value)) { m_value = -m_value;  return *this; }
 
+        //two affine points (like Celsius temperatures) have no meaningful sum, and their difference is a delta, so
+        //neither can be stored in place in a point
         template<typename NumericType2, typename OtherConversion>
+            requires (!(b_is_point_conversion<ConversionImpl> && b_is_point_conversion<OtherConversion>))
         constexpr Unit& operator+=(const Unit<NumericType2, Quantity, OtherConversion>& other);
 
         template<typename NumericType2, typename OtherConversion>
+            requires (!(b_is_point_conversion<ConversionImpl> && b_is_point_conversion<OtherConversion>))
         constexpr Unit& operator-=(const Unit<NumericType2, Quantity, OtherConversion>& other);
 
         template<typename NumericType2 = ValueType>
@@ -63,7 +80,7 @@ namespace units
         Unit& fromUnscaled(NumericType2&& value);
 
         //converts this to an unscaled/standard unit
-        template<typename NumericType2 = ValueType>
+        template<typename NumericType2 = ComputeType<ValueType>>
         constexpr Unit<NumericType2, Quantity, NoConversion> toUnscaled()const;
 
         template<typename NewConversionImpl, typename NumericType2 = ValueType>
@@ -87,19 +104,83 @@ namespace units
     template<typename N, typename Q, typename C>
     constexpr bool b_is_unit<Unit<N, Q, C>> = true;
 
+    //whether an array of U can be viewed as an array of its ValueType and back, as as_raw_span in spans.h and
+    //StateVector in state.h do, which check it for the units they are given. it holds for every Unit whose
+    //NumericType is trivially copyable and standard layout, as the conversion base has no members
+    template<typename U>
+    constexpr bool b_is_raw_layout = sizeof(U) == sizeof(typename U::ValueType) && alignof(U) == alignof(typename U::ValueType)
+        && std::is_standard_layout_v<U> && std::is_trivially_copyable_v<U>;
+
+    static_assert(b_is_raw_layout<Unit<double, Quantity<>>>);
+    static_assert(b_is_raw_layout<Unit<float, Quantity<>>>);
+    static_assert(b_is_raw_layout<Unit<double, Quantity<>, conversions::kilo>>);
+    static_assert(b_is_raw_layout<Unit<std::int64_t, Quantity<>, conversions::milli>>);
+    static_assert(b_is_raw_layout<Unit<double, Quantity<>, conversions::celsius>>);
+    static_assert(b_is_raw_layout<Unit<double, Quantity<>, conversions::celsius::Delta>>);
+
+    template<typename T>
+    concept UnitType = b_is_unit<T>;
+
+    //a type a unit can be scaled by: anything arithmetic that isn't a unit itself
+    template<typename T>
+    concept Scalar = !UnitType<T> && Arithmetic<T>;
+
+    //the conversion of the result of a binary operation between two units
+    template<typename Conversion1, typename Conversion2>
+    using CommonConversion = BoolTypePredicate<b_is_same<Conversion1, Conversion2>, NoConversion, Conversion1>;
+
+    //the result of multiplying or dividing units: a Unit, or the bare NumericType if the quantity is dimensionless
+    template<typename N, typename Q, typename C>
+    using UnitOrNumeric = BoolTypePredicate<b_is_dimensionless<Q>, Unit<N, Q, C>, N>;
+
+    //for linear conversions with an intercept (like Celsius), values are affine points and differences between them
+    //are deltas, which are in the conversion's DeltaConversion. a point and a delta add in the point's conversion,
+    //and two points of the same conversion subtract to a delta; both without going through the standard unit.
+    //two points don't add: operator+ and operator+= reject them. a point and a plain ratio conversion (like kelvins)
+    //are both values, and combine through the standard unit
+    template<typename Conversion1, typename Conversion2>
+    using SumConversion = BoolTypePredicate<b_is_point_delta<Conversion1> && b_is_point_conversion<Conversion2>,
+        BoolTypePredicate<b_is_point_conversion<Conversion1> && b_is_point_delta<Conversion2>, CommonConversion<Conversion1, Conversion2>, Conversion1>,
+        Conversion2>;
+
+    template<typename Conversion1, typename Conversion2>
+    struct DifferenceConversionHelper
+    {
+        using type = BoolTypePredicate<b_is_point_conversion<Conversion1> && b_is_point_delta<Conversion2>, CommonConversion<Conversion1, Conversion2>, Conversion1>;
+    };
+
+    template<LinearConversion Conversion1>
+    struct DifferenceConversionHelper<Conversion1, Conversion1>
+    {
+        using type = DeltaOf<Conversion1>;
+    };
+
+    template<typename Conversion1, typename Conversion2>
+    using DifferenceConversion = typename DifferenceConversionHelper<Conversion1, Conversion2>::type;
+
+    //the value of a delta unit, in the delta conversion of PointConversion
+    template<LinearConversion PointConversion, typename N, typename Q, typename C>
+    constexpr ComputeType<N> deltaValue(const Unit<N, Q, C>& delta)
+    {
+        if constexpr (b_is_same<C, DeltaOf<PointConversion>>) return delta.value();
+        else return DeltaOf<PointConversion>::standardToUnit(C::unitToStandard(static_cast<ComputeType<N>>(delta.value())));
+    }
+
     template<typename N, typename Q, typename C>
     template<typename T, typename O>
+        requires (!b_is_point_and_delta<C, O>)
     constexpr Unit<N, Q, C>::Unit(const Unit<T, Q, O>& other):
-        m_value{standardToUnit(other.unitToStandard(other.m_value))}
+        m_value{static_cast<N>(this->standardToUnit(other.unitToStandard(static_cast<ComputeType<T>>(other.m_value))))}
     {
         
     }
 
     template<typename N, typename Q, typename C>
     template<typename T, typename O>
+        requires (!b_is_point_and_delta<C, O>)
     constexpr Unit<N, Q, C>& Unit<N, Q, C>::operator=(const Unit<T, Q, O>& other)
     {
-        m_value = standardToUnit(other.unitToStandard(other.m_value));
+        m_value = static_cast<N>(this->standardToUnit(other.unitToStandard(static_cast<ComputeType<T>>(other.m_value))));
         return *this;
     }
 
@@ -107,7 +188,7 @@ namespace units
     template<typename T>
     Unit<N, Q, C>& Unit<N, Q, C>::fromUnscaled(T&& t)
     {
-        m_value = this->standardToUnit(t);
+        m_value = static_cast<N>(this->standardToUnit(t));
         return *this;
     }
 
@@ -115,7 +196,7 @@ namespace units
     template<typename T>
     constexpr Unit<T, Q, NoConversion> Unit<N, Q, C>::toUnscaled()const
     {
-        return Unit<T, Q, NoConversion>(this->unitToStandard(m_value));
+        return Unit<T, Q, NoConversion>(this->unitToStandard(static_cast<T>(m_value)));
     }
 
     template<typename N, typename Q, typename C>
@@ -138,89 +219,134 @@ namespace units
     template<typename O, typename T>
     constexpr Unit<T, Q, O> Unit<N, Q, C>::toUnit()const
     {
-        return Unit<T, Q, O>{this->unitToStandard(m_value)};
+        return Unit<T, Q, O>(*this);
     }
 
     template<typename N, typename Q, typename C>
     template<typename U, typename O>
+        requires (!(b_is_point_conversion<C> && b_is_point_conversion<O>))
     constexpr Unit<N, Q, C>& units::Unit<N, Q, C>::operator+=(const Unit<U, Q, O>& other)
     {
-        m_value += this->standardToUnit(other.unitToStandard(other.m_value));
+        if constexpr (b_is_same<C, O>) m_value += other.m_value;
+        else if constexpr (b_is_point_conversion<C> && b_is_point_delta<O>) m_value += DeltaOf<C>::standardToUnit(O::unitToStandard(static_cast<ComputeType<U>>(other.m_value)));
+        else m_value += this->standardToUnit(other.unitToStandard(static_cast<ComputeType<U>>(other.m_value)));
         return *this;
     }
     
     template<typename N, typename Q, typename C>
     template<typename U, typename O>
+        requires (!(b_is_point_conversion<C> && b_is_point_conversion<O>))
     constexpr Unit<N, Q, C>& units::Unit<N, Q, C>::operator-=(const Unit<U, Q, O>& other)
     {
-        m_value -= this->standardToUnit(other.unitToStandard(other.m_value));
+        if constexpr (b_is_same<C, O>) m_value -= other.m_value;
+        else if constexpr (b_is_point_conversion<C> && b_is_point_delta<O>) m_value -= DeltaOf<C>::standardToUnit(O::unitToStandard(static_cast<ComputeType<U>>(other.m_value)));
+        else m_value -= this->standardToUnit(other.unitToStandard(static_cast<ComputeType<U>>(other.m_value)));
         return *this;
     }
 
-    template<typename NumericType1, typename QuantityType, typename Conversion1, typename NumericType2, typename Conversion2,
-    typename N = AddType<NumericType1, NumericType2>,
-    typename C = BoolTypePredicate<b_is_same<Conversion1, Conversion2>, NoConversion, Conversion1>>
-        Unit<N, QuantityType, C> operator+(const Unit<NumericType1, QuantityType, Conversion1>& c1, const Unit<NumericType2, QuantityType, Conversion2>& c2)
+    //the operators below are constrained rather than relying on defaulted template arguments, so that candidates which
+    //aren't viable are discarded before their result types are substituted.
+
+    template<typename N1, typename Q, typename C1, typename N2, typename C2>
+        requires Addable<N1, N2> && ConversionPolicy<C1, N1> && ConversionPolicy<C2, N2> && (!(b_is_point_conversion<C1> && b_is_point_conversion<C2>))
+    Unit<AddType<N1, N2>, Q, SumConversion<C1, C2>> operator+(const Unit<N1, Q, C1>& c1, const Unit<N2, Q, C2>& c2)
     {
-        Unit<N, QuantityType, C> out;
-        return out.fromUnscaled(c1.toUnscaled().value() + c2.toUnscaled().value());
+        using Out = Unit<AddType<N1, N2>, Q, SumConversion<C1, C2>>;
+        if constexpr (b_is_delta_conversion<C1> && b_is_same<C1, C2>) return Out(c1.value() + c2.value());
+        else if constexpr (b_is_point_conversion<C1> && b_is_point_delta<C2>) return Out(c1.value() + deltaValue<C1>(c2));
+        else if constexpr (b_is_point_delta<C1> && b_is_point_conversion<C2>) return Out(deltaValue<C2>(c1) + c2.value());
+        else
+        {
+            Out out;
+            return out.fromUnscaled(c1.toUnscaled().value() + c2.toUnscaled().value());
+        }
     }
 
-    template<typename NumericType1, typename QuantityType, typename Conversion1, typename NumericType2, typename Conversion2,
-        typename N = SubtractType<NumericType1, NumericType2>,
-        typename C = BoolTypePredicate<b_is_same<Conversion1, Conversion2>, NoConversion, Conversion1>>
-        Unit<N, QuantityType, C> operator-(const Unit<NumericType1, QuantityType, Conversion1>& c1, const Unit<NumericType2, QuantityType, Conversion2>& c2)
+    template<typename N1, typename Q, typename C1, typename N2, typename C2>
+        requires Subtractable<N1, N2> && ConversionPolicy<C1, N1> && ConversionPolicy<C2, N2>
+    Unit<SubtractType<N1, N2>, Q, DifferenceConversion<C1, C2>> operator-(const Unit<N1, Q, C1>& c1, const Unit<N2, Q, C2>& c2)
     {
-        Unit<N, QuantityType, C> out;
-        return out.fromUnscaled(c1.toUnscaled().value() - c2.toUnscaled().value());
+        using Out = Unit<SubtractType<N1, N2>, Q, DifferenceConversion<C1, C2>>;
+        if constexpr (LinearConversion<C1> && b_is_same<C1, C2>) return Out(c1.value() - c2.value());
+        else if constexpr (b_is_point_conversion<C1> && b_is_point_delta<C2>) return Out(c1.value() - deltaValue<C1>(c2));
+        else
+        {
+            Out out;
+            return out.fromUnscaled(c1.toUnscaled().value() - c2.toUnscaled().value());
+        }
     }
 
-    template<typename NumericType1, typename QuantityType1, typename Conversion1, typename NumericType2, typename QuantityType2, typename Conversion2,
-        typename N = MultiplyType<NumericType1, NumericType2>,
-        typename Q = MultiplyType<QuantityType1, QuantityType2>,
-        typename C = BoolTypePredicate<b_is_same<Conversion1, Conversion2>, NoConversion, Conversion1>>
-        Unit<N, Q, C> operator*(const Unit<NumericType1, QuantityType1, Conversion1>& c1, const Unit<NumericType2, QuantityType2, Conversion2>& c2)
+    template<typename N1, QuantityType Q1, typename C1, typename N2, QuantityType Q2, typename C2>
+        requires Multipliable<N1, N2> && ConversionPolicy<C1, N1> && ConversionPolicy<C2, N2>
+    UnitOrNumeric<MultiplyType<N1, N2>, MultiplyType<Q1, Q2>, CommonConversion<C1, C2>> operator*(const Unit<N1, Q1, C1>& c1, const Unit<N2, Q2, C2>& c2)
     {
-        Unit<N, Q, C> out;
-        return out.fromUnscaled(c1.toUnscaled().value() * c2.toUnscaled().value());
+        using N = MultiplyType<N1, N2>;
+        if constexpr (b_is_dimensionless<MultiplyType<Q1, Q2>> && b_is_delta_conversion<C1> && b_is_delta_conversion<C2>)
+        {
+            //ratio conversions fold into a single constant, which is left out entirely when it's 1
+            constexpr ComputeType<N> k = C1::unitToStandard(ComputeType<N>(1)) * C2::unitToStandard(ComputeType<N>(1));
+            if constexpr (k == ComputeType<N>(1)) return c1.value() * c2.value();
+            else return static_cast<N>(k * (c1.value() * c2.value()));
+        }
+        else if constexpr (b_is_dimensionless<MultiplyType<Q1, Q2>>)
+        {
+            return static_cast<N>(c1.toUnscaled().value() * c2.toUnscaled().value());
+        }
+        else
+        {
+            Unit<N, MultiplyType<Q1, Q2>, CommonConversion<C1, C2>> out;
+            return out.fromUnscaled(c1.toUnscaled().value() * c2.toUnscaled().value());
+        }
     }
 
-    template<typename NumericType1, typename QuantityType, typename Conversion, typename NumericType2,
-        typename N = typename TypePredicate<!b_is_unit<NumericType2>, MultiplyType<NumericType1, NumericType2>>::type>
-        Unit<N, QuantityType, Conversion> operator*(const Unit<NumericType1, QuantityType, Conversion>& u, const NumericType2& f)
+    template<typename N, typename Q, typename C, Scalar S>
+        requires Multipliable<N, S>
+    Unit<MultiplyType<N, S>, Q, C> operator*(const Unit<N, Q, C>& u, const S& f)
     {
-        return Unit<N, QuantityType, Conversion>(u.value() * f);
+        return Unit<MultiplyType<N, S>, Q, C>(u.value() * f);
     }
 
-    template<typename NumericType1, typename NumericType2, typename QuantityType, typename Conversion,
-        typename N = typename TypePredicate<!b_is_unit<NumericType1>, MultiplyType<NumericType1, NumericType2>>::type>
-        Unit<N, QuantityType, Conversion> operator*(const NumericType1& f, const Unit<NumericType2, QuantityType, Conversion>& u)
+    template<Scalar S, typename N, typename Q, typename C>
+        requires Multipliable<S, N>
+    Unit<MultiplyType<S, N>, Q, C> operator*(const S& f, const Unit<N, Q, C>& u)
     {
-        return Unit<N, QuantityType, Conversion>(f * u.value());
+        return Unit<MultiplyType<S, N>, Q, C>(f * u.value());
     }
 
-    template<typename NumericType1, typename QuantityType1, typename Conversion1, typename NumericType2, typename QuantityType2, typename Conversion2,
-        typename N = DivideType<NumericType1, NumericType2>,
-        typename Q = DivideType<QuantityType1, QuantityType2>,
-        typename C = BoolTypePredicate<b_is_same<Conversion1, Conversion2>, NoConversion, Conversion1>>
-        Unit<N, Q, C> operator/(const Unit<NumericType1, QuantityType1, Conversion1>& c1, const Unit<NumericType2, QuantityType2, Conversion2>& c2)
+    template<typename N1, QuantityType Q1, typename C1, typename N2, QuantityType Q2, typename C2>
+        requires Divisible<N1, N2> && ConversionPolicy<C1, N1> && ConversionPolicy<C2, N2>
+    UnitOrNumeric<DivideType<N1, N2>, DivideType<Q1, Q2>, CommonConversion<C1, C2>> operator/(const Unit<N1, Q1, C1>& c1, const Unit<N2, Q2, C2>& c2)
     {
-        Unit<N, Q, C> out;
-        return out.fromUnscaled(c1.toUnscaled().value() / c2.toUnscaled().value());
+        using N = DivideType<N1, N2>;
+        if constexpr (b_is_dimensionless<DivideType<Q1, Q2>> && b_is_delta_conversion<C1> && b_is_delta_conversion<C2>)
+        {
+            constexpr ComputeType<N> k = C1::unitToStandard(ComputeType<N>(1)) / C2::unitToStandard(ComputeType<N>(1));
+            if constexpr (k == ComputeType<N>(1)) return c1.value() / c2.value();
+            else return static_cast<N>(k * (c1.value() / c2.value()));
+        }
+        else if constexpr (b_is_dimensionless<DivideType<Q1, Q2>>)
+        {
+            return static_cast<N>(c1.toUnscaled().value() / c2.toUnscaled().value());
+        }
+        else
+        {
+            Unit<N, DivideType<Q1, Q2>, CommonConversion<C1, C2>> out;
+            return out.fromUnscaled(c1.toUnscaled().value() / c2.toUnscaled().value());
+        }
     }
 
-    template<typename NumericType1, typename QuantityType, typename Conversion, typename NumericType2,
-        typename N = typename TypePredicate<!b_is_unit<NumericType2>, DivideType<NumericType1, NumericType2>>::type>
-        Unit<N, QuantityType, Conversion> operator/(const Unit<NumericType1, QuantityType, Conversion>& u, const NumericType2& f)
+    template<typename N, typename Q, typename C, Scalar S>
+        requires Divisible<N, S>
+    Unit<DivideType<N, S>, Q, C> operator/(const Unit<N, Q, C>& u, const S& f)
     {
-        return Unit<N, QuantityType, Conversion>(u.value() / f);
+        return Unit<DivideType<N, S>, Q, C>(u.value() / f);
     }
 
-    template<typename NumericType1, typename NumericType2, typename QuantityType, typename Conversion,
-        typename N = typename TypePredicate<!b_is_unit<NumericType1>, DivideType<NumericType1, NumericType2>>::type>
-        Unit<N, QuantityType, Conversion> operator/(const NumericType1& f, const Unit<NumericType2, QuantityType, Conversion>& u)
+    template<Scalar S, typename N, typename Q, typename C>
+        requires Divisible<S, N>
+    Unit<DivideType<S, N>, Q, C> operator/(const S& f, const Unit<N, Q, C>& u)
     {
-        return Unit<N, QuantityType, Conversion>(f / u.value());
+        return Unit<DivideType<S, N>, Q, C>(f / u.value());
     }
 }
 
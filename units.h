@@ -45,6 +45,21 @@ namespace units
 	DECLARE_MAGNITUDE_UNITS(ampere, quantities::Current);
 
 
+	template<typename FloatType>
+	using kelvins = Unit<FloatType, quantities::Temperature>;
+
+	template<typename FloatType>
+	using degreesCelsius = Unit<FloatType, quantities::Temperature, conversions::celsius>;
+
+	template<typename FloatType>
+	using degreesCelsiusDelta = Unit<FloatType, quantities::Temperature, DeltaOf<conversions::celsius>>;
+
+	template<typename FloatType>
+	using degreesFahrenheit = Unit<FloatType, quantities::Temperature, conversions::fahrenheit>;
+
+	template<typename FloatType>
+	using degreesFahrenheitDelta = Unit<FloatType, quantities::Temperature, DeltaOf<conversions::fahrenheit>>;
+
 	template<typename FloatType>
 	using newtons = Unit<FloatType, quantities::Force>;
 	DECLARE_MAGNITUDE_UNITS(newtons, quantities::Force);
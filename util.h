@@ -36,6 +36,33 @@ namespace units
     template<typename T, typename U, typename Q = decltype(declval<T>()/declval<U>())>
     using DivideType = Q;
 
+    //a type which implements the operators +, -, * and / between instances of itself
+    template<typename T>
+    concept Arithmetic = requires(const T& a, const T& b) { a + b; a - b; a * b; a / b; };
+
+    template<typename T, typename U>
+    concept Addable = requires(const T& t, const U& u) { t + u; };
+
+    template<typename T, typename U>
+    concept Subtractable = requires(const T& t, const U& u) { t - u; };
+
+    template<typename T, typename U>
+    concept Multipliable = requires(const T& t, const U& u) { t * u; };
+
+    template<typename T, typename U>
+    concept Divisible = requires(const T& t, const U& u) { t / u; };
+
+    //the type that arithmetic and conversions on a NumericType are carried out in. storage-only numeric types
+    //specialise this with the wider type they expand to
+    template<typename T>
+    struct ComputeTypeHelper
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    using ComputeType = typename ComputeTypeHelper<T>::type;
+
     template<typename T>
     struct IsEmptyHelper : T 
     {
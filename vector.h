@@ -0,0 +1,274 @@
+#ifndef UNITS_VECTOR_H
+#define UNITS_VECTOR_H
+
+#include "conversions.h"
+#include "unit.h"
+
+#include <bit>
+#include <cmath>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+
+namespace units
+{
+    /// <summary>
+    /// A fixed-size vector of one quantity, e.g. UnitVec3&lt;double, quantities::Force&gt;. The components are stored
+    /// raw and aligned to the whole vector; the lanes are padded to a power of two (a 3-vector to 4, the last kept at 0)
+    /// so that every operation is a fixed-width loop the compiler turns into vector instructions, with no per-component Unit work.
+    /// Conversions must be ratios: a vector of affine points (Celsius) has no meaningful length.
+    /// </summary>
+    template<typename N, typename Q, typename C = NoConversion, size_t Dim = 3>
+    class UnitVec
+    {
+    public:
+        static_assert(b_is_delta_conversion<C>, "unit vectors need a ratio conversion");
+
+        using ValueType = N;
+        using Quantity = Q;
+        using ConversionType = C;
+        using Component = Unit<N, Q, C>;
+
+        static constexpr size_t dimension = Dim;
+        static constexpr size_t lanes = std::bit_ceil(Dim);
+
+        constexpr UnitVec()noexcept : m_values{} {}
+
+        template<typename ... Ns>
+            requires (sizeof...(Ns) == Dim && (std::is_convertible_v<Ns, N> && ...))
+        explicit constexpr UnitVec(Ns... values)noexcept : m_values{ static_cast<N>(values)... } {}
+
+        template<typename ... Cs>
+            requires (sizeof...(Cs) == Dim && (std::is_same_v<Cs, Component> && ...))
+        constexpr UnitVec(const Cs&... components)noexcept : m_values{ components.value()... } {}
+
+        constexpr Component operator[](size_t i)const noexcept { return Component(m_values[i]); }
+        constexpr N& value(size_t i)noexcept { return m_values[i]; }
+        constexpr const N& value(size_t i)const noexcept { return m_values[i]; }
+
+        N* data()noexcept { return m_values; }
+        const N* data()const noexcept { return m_values; }
+
+        template<typename C2>
+        constexpr UnitVec& operator+=(const UnitVec<N, Q, C2, Dim>& other)noexcept;
+
+        template<typename C2>
+        constexpr UnitVec& operator-=(const UnitVec<N, Q, C2, Dim>& other)noexcept;
+
+        template<Scalar S>
+        constexpr UnitVec& operator*=(const S& s)noexcept
+        {
+            for (size_t i = 0; i < lanes; ++i) m_values[i] *= s;
+            return *this;
+        }
+
+        template<Scalar S>
+        constexpr UnitVec& operator/=(const S& s)noexcept
+        {
+            const N inverse = N(1) / s;
+            for (size_t i = 0; i < lanes; ++i) m_values[i] *= inverse;
+            return *this;
+        }
+
+        constexpr UnitVec operator-()const noexcept
+        {
+            UnitVec out;
+            for (size_t i = 0; i < lanes; ++i) out.m_values[i] = -m_values[i];
+            return out;
+        }
+
+    private:
+        alignas(std::bit_ceil(lanes * sizeof(N))) N m_values[lanes];
+    };
+
+    template<typename N, typename Q, typename C = NoConversion>
+    using UnitVec3 = UnitVec<N, Q, C, 3>;
+
+    template<typename N, typename Q, typename C = NoConversion>
+    using UnitVec4 = UnitVec<N, Q, C, 4>;
+
+    template<typename T>
+    constexpr bool b_is_unit_vec = false;
+
+    template<typename N, typename Q, typename C, size_t Dim>
+    constexpr bool b_is_unit_vec<UnitVec<N, Q, C, Dim>> = true;
+
+    template<typename N, typename Q, typename C, size_t Dim>
+    template<typename C2>
+    constexpr UnitVec<N, Q, C, Dim>& UnitVec<N, Q, C, Dim>::operator+=(const UnitVec<N, Q, C2, Dim>& other)noexcept
+    {
+        constexpr N k = affine<C2, C, N>().scale;
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            if constexpr (k == N(1)) m_values[i] += other.value(i);
+            else m_values[i] += k * other.value(i);
+        }
+        return *this;
+    }
+
+    template<typename N, typename Q, typename C, size_t Dim>
+    template<typename C2>
+    constexpr UnitVec<N, Q, C, Dim>& UnitVec<N, Q, C, Dim>::operator-=(const UnitVec<N, Q, C2, Dim>& other)noexcept
+    {
+        constexpr N k = affine<C2, C, N>().scale;
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            if constexpr (k == N(1)) m_values[i] -= other.value(i);
+            else m_values[i] -= k * other.value(i);
+        }
+        return *this;
+    }
+
+    template<typename N, typename Q, typename C, typename C2, size_t Dim>
+    constexpr UnitVec<N, Q, C, Dim> operator+(UnitVec<N, Q, C, Dim> a, const UnitVec<N, Q, C2, Dim>& b)noexcept
+    {
+        return a += b;
+    }
+
+    template<typename N, typename Q, typename C, typename C2, size_t Dim>
+    constexpr UnitVec<N, Q, C, Dim> operator-(UnitVec<N, Q, C, Dim> a, const UnitVec<N, Q, C2, Dim>& b)noexcept
+    {
+        return a -= b;
+    }
+
+    //b_is_unit_vec is checked first, so that testing whether a UnitVec is a Scalar doesn't recurse into these
+    template<typename N, typename Q, typename C, size_t Dim, typename S> requires (!b_is_unit_vec<S> && Scalar<S>)
+    constexpr UnitVec<N, Q, C, Dim> operator*(UnitVec<N, Q, C, Dim> v, const S& s)noexcept
+    {
+        return v *= s;
+    }
+
+    template<typename S, typename N, typename Q, typename C, size_t Dim> requires (!b_is_unit_vec<S> && Scalar<S>)
+    constexpr UnitVec<N, Q, C, Dim> operator*(const S& s, UnitVec<N, Q, C, Dim> v)noexcept
+    {
+        return v *= s;
+    }
+
+    template<typename N, typename Q, typename C, size_t Dim, typename S> requires (!b_is_unit_vec<S> && Scalar<S>)
+    constexpr UnitVec<N, Q, C, Dim> operator/(UnitVec<N, Q, C, Dim> v, const S& s)noexcept
+    {
+        return v /= s;
+    }
+
+    //scales a vector by a unit, e.g. a mass times an acceleration. the result is in the standard unit of the product
+    template<typename N, typename Q1, typename C1, typename Q2, typename C2, size_t Dim>
+    constexpr UnitVec<N, MultiplyType<Q1, Q2>, NoConversion, Dim> operator*(const Unit<N, Q1, C1>& s, const UnitVec<N, Q2, C2, Dim>& v)noexcept
+    {
+        const N k = affine<C1, NoConversion, N>().scale * affine<C2, NoConversion, N>().scale * s.value();
+        UnitVec<N, MultiplyType<Q1, Q2>, NoConversion, Dim> out;
+        for (size_t i = 0; i < UnitVec<N, Q2, C2, Dim>::lanes; ++i) out.value(i) = k * v.value(i);
+        return out;
+    }
+
+    template<typename N, typename Q1, typename C1, typename Q2, typename C2, size_t Dim>
+    constexpr UnitVec<N, MultiplyType<Q1, Q2>, NoConversion, Dim> operator*(const UnitVec<N, Q1, C1, Dim>& v, const Unit<N, Q2, C2>& s)noexcept
+    {
+        return s * v;
+    }
+
+    //e.g. Force · Length is Energy. like unit.h's operator*, a dimensionless result is the bare NumericType
+    template<typename N, typename Q1, typename C1, typename Q2, typename C2, size_t Dim>
+    constexpr UnitOrNumeric<N, MultiplyType<Q1, Q2>, NoConversion> dot(const UnitVec<N, Q1, C1, Dim>& a, const UnitVec<N, Q2, C2, Dim>& b)noexcept
+    {
+        constexpr N k = affine<C1, NoConversion, N>().scale * affine<C2, NoConversion, N>().scale;
+        N sum{};
+        for (size_t i = 0; i < UnitVec<N, Q1, C1, Dim>::lanes; ++i) sum += a.value(i) * b.value(i);
+        if constexpr (b_is_dimensionless<MultiplyType<Q1, Q2>>) return k * sum;
+        else return Unit<N, MultiplyType<Q1, Q2>, NoConversion>(k * sum);
+    }
+
+    //e.g. Length × Force. the result has the dimensions of Q1 * Q2, which for Length × Force are those of Energy:
+    //quantities::Moment is Energy / Angle, so b_is_same<Moment, ...> doesn't hold without an Angle
+    template<typename N, typename Q1, typename C1, typename Q2, typename C2>
+    constexpr UnitVec<N, MultiplyType<Q1, Q2>, NoConversion, 3> cross(const UnitVec<N, Q1, C1, 3>& a, const UnitVec<N, Q2, C2, 3>& b)noexcept
+    {
+        constexpr N k = affine<C1, NoConversion, N>().scale * affine<C2, NoConversion, N>().scale;
+        return UnitVec<N, MultiplyType<Q1, Q2>, NoConversion, 3>(
+            k * (a.value(1) * b.value(2) - a.value(2) * b.value(1)),
+            k * (a.value(2) * b.value(0) - a.value(0) * b.value(2)),
+            k * (a.value(0) * b.value(1) - a.value(1) * b.value(0)));
+    }
+
+    template<typename N, typename Q, typename C, size_t Dim>
+    constexpr Unit<N, MultiplyType<Q, Q>, NoConversion> squaredNorm(const UnitVec<N, Q, C, Dim>& v)noexcept
+    {
+        constexpr N k = affine<C, NoConversion, N>().scale * affine<C, NoConversion, N>().scale;
+        N sum{};
+        for (size_t i = 0; i < UnitVec<N, Q, C, Dim>::lanes; ++i) sum += v.value(i) * v.value(i);
+        return Unit<N, MultiplyType<Q, Q>, NoConversion>(k * sum);
+    }
+
+    //the length of a vector, in its own conversion. the norm of a Velocity is a quantities::Speed, which is an alias of Velocity
+    template<typename N, typename Q, typename C, size_t Dim>
+    Unit<N, Q, C> norm(const UnitVec<N, Q, C, Dim>& v)noexcept
+    {
+        N sum{};
+        for (size_t i = 0; i < UnitVec<N, Q, C, Dim>::lanes; ++i) sum += v.value(i) * v.value(i);
+        return Unit<N, Q, C>(std::sqrt(sum));
+    }
+
+    //the direction of a vector, as a dimensionless vector of length 1
+    template<typename N, typename Q, typename C, size_t Dim>
+    UnitVec<N, Quantity<>, NoConversion, Dim> normalize(const UnitVec<N, Q, C, Dim>& v)noexcept
+    {
+        N sum{};
+        for (size_t i = 0; i < UnitVec<N, Q, C, Dim>::lanes; ++i) sum += v.value(i) * v.value(i);
+        const N inverse = N(1) / std::sqrt(sum);
+        UnitVec<N, Quantity<>, NoConversion, Dim> out;
+        for (size_t i = 0; i < UnitVec<N, Q, C, Dim>::lanes; ++i) out.value(i) = v.value(i) * inverse;
+        return out;
+    }
+
+    namespace vector
+    {
+        template<typename V, typename ... Cs>
+        concept ComponentRanges = std::ranges::contiguous_range<V> && b_is_unit_vec<std::ranges::range_value_t<V>>
+            && sizeof...(Cs) == std::ranges::range_value_t<V>::dimension
+            && ((std::ranges::contiguous_range<Cs> && std::is_same_v<std::ranges::range_value_t<Cs>, typename std::ranges::range_value_t<V>::Component>) && ...);
+
+        template<typename V, typename ... Cs>
+        void checkSizes(const V& vectors, const Cs&... components)
+        {
+            const size_t n = std::ranges::size(vectors);
+            if (((std::ranges::size(components) != n) || ...)) throw std::invalid_argument("every component range must be as long as the vectors");
+        }
+    }
+
+    //splits an array of vectors into one array per component, e.g. toComponents(forces, xs, ys, zs), for loops that
+    //work on all x values at once. each component range must be as long as vectors, or this throws std::invalid_argument
+    template<typename V, typename ... Cs>
+        requires vector::ComponentRanges<V, Cs...>
+    void toComponents(const V& vectors, Cs&&... components)
+    {
+        using Component = typename std::ranges::range_value_t<V>::Component;
+        vector::checkSizes(vectors, components...);
+        const auto* src = std::ranges::data(vectors);
+        const size_t n = std::ranges::size(vectors);
+        size_t d = 0;
+        ([&](Component* dst)
+        {
+            for (size_t i = 0; i < n; ++i) dst[i] = Component(src[i].value(d));
+            ++d;
+        }(std::ranges::data(components)), ...);
+    }
+
+    //joins one array per component back into an array of vectors, e.g. fromComponents(forces, xs, ys, zs).
+    //each component range must be as long as vectors, or this throws std::invalid_argument
+    template<typename V, typename ... Cs>
+        requires vector::ComponentRanges<V, Cs...>
+    void fromComponents(V&& vectors, const Cs&... components)
+    {
+        using Component = typename std::ranges::range_value_t<V>::Component;
+        vector::checkSizes(vectors, components...);
+        auto* dst = std::ranges::data(vectors);
+        const size_t n = std::ranges::size(vectors);
+        size_t d = 0;
+        ([&](const Component* src)
+        {
+            for (size_t i = 0; i < n; ++i) dst[i].value(d) = src[i].value();
+            ++d;
+        }(std::ranges::data(components)), ...);
+    }
+}
+
+#endif
@@ -0,0 +1,416 @@
+#ifndef UNITS_WIRE_H
+#define UNITS_WIRE_H
+
+#include "conversions.h"
+#include "signature.h"
+#include "unit.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace units
+{
+    class WireError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    namespace wire
+    {
+        //specialised for each record type by CREATE_WIRE_RECORD, holding a tuple of pointers to its Unit members
+        template<typename Record>
+        struct RecordFields;
+
+        enum class Kind : std::uint8_t
+        {
+            Float,
+            Signed,
+            Unsigned,
+        };
+
+        /// <summary>
+        /// What a stream says about one field: its dimensions, how its value is stored, and the scale and offset
+        /// which take a stored value to the standard unit. Written once at the start of a stream.
+        /// </summary>
+        struct FieldSchema
+        {
+            Signature signature;
+            Kind kind = Kind::Float;
+            std::uint8_t size = 0;
+            double scale = 1.0;
+            double offset = 0.0;
+
+            constexpr bool operator==(const FieldSchema&)const = default;
+        };
+
+        //"UWR" and a version, then a 16 bit field count
+        constexpr char magic[4] = { 'U', 'W', 'R', '1' };
+        constexpr size_t header_bytes = sizeof(magic) + 2;
+        //the exponents, kind and size as a byte each, then scale and offset as doubles
+        constexpr size_t field_bytes = n_standard_tags + 2 + 2 * sizeof(double);
+
+        template<typename Record, auto Member>
+        using FieldType = std::remove_cvref_t<decltype(std::declval<Record&>().*Member)>;
+
+        template<UnitType U>
+        constexpr FieldSchema fieldSchema()noexcept
+        {
+            using N = typename U::ValueType;
+            using C = typename U::ConversionType;
+            static_assert(std::is_arithmetic_v<N>, "wire fields must have an arithmetic NumericType");
+            static_assert(LinearConversion<C>, "wire fields need ratio or linear conversions");
+
+            FieldSchema f;
+            f.signature = signature_of<typename U::Quantity>;
+            f.kind = std::is_floating_point_v<N> ? Kind::Float : std::is_signed_v<N> ? Kind::Signed : Kind::Unsigned;
+            f.size = static_cast<std::uint8_t>(sizeof(N));
+            const Affine<double> toStandard = affine<C, NoConversion, double>();
+            f.scale = toStandard.scale;
+            f.offset = toStandard.offset;
+            return f;
+        }
+
+        //copies a value to or from little-endian bytes
+        template<typename T>
+        inline void store(std::byte* dst, T value)noexcept
+        {
+            std::memcpy(dst, &value, sizeof(T));
+            if constexpr (std::endian::native == std::endian::big) std::reverse(dst, dst + sizeof(T));
+        }
+
+        template<typename T>
+        inline T load(const std::byte* src)noexcept
+        {
+            T value;
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                std::byte bytes[sizeof(T)];
+                std::reverse_copy(src, src + sizeof(T), bytes);
+                std::memcpy(&value, bytes, sizeof(T));
+            }
+            else
+            {
+                std::memcpy(&value, src, sizeof(T));
+            }
+            return value;
+        }
+
+        //whether loadAny can read a value of this kind and size
+        constexpr bool isSupported(Kind kind, std::uint8_t size)noexcept
+        {
+            switch (kind)
+            {
+            case Kind::Float: return size == 4 || size == 8;
+            case Kind::Signed:
+            case Kind::Unsigned: return size == 1 || size == 2 || size == 4 || size == 8;
+            }
+            return false;
+        }
+
+        //reads a value stored with a kind and size other than the reader's
+        inline double loadAny(const std::byte* src, Kind kind, std::uint8_t size)
+        {
+            switch (kind)
+            {
+            case Kind::Float:
+                if (size == 4) return load<float>(src);
+                if (size == 8) return load<double>(src);
+                break;
+            case Kind::Signed:
+                if (size == 1) return load<std::int8_t>(src);
+                if (size == 2) return load<std::int16_t>(src);
+                if (size == 4) return load<std::int32_t>(src);
+                if (size == 8) return static_cast<double>(load<std::int64_t>(src));
+                break;
+            case Kind::Unsigned:
+                if (size == 1) return load<std::uint8_t>(src);
+                if (size == 2) return load<std::uint16_t>(src);
+                if (size == 4) return load<std::uint32_t>(src);
+                if (size == 8) return static_cast<double>(load<std::uint64_t>(src));
+                break;
+            }
+            throw WireError("unsupported field encoding");
+        }
+
+        template<typename Record>
+        struct RecordLayout
+        {
+            static constexpr auto members = RecordFields<Record>::members;
+            static constexpr size_t n_fields = std::tuple_size_v<std::remove_cvref_t<decltype(members)>>;
+
+            template<size_t I>
+            using Field = FieldType<Record, std::get<I>(members)>;
+
+            template<size_t ... Is>
+            static constexpr std::array<FieldSchema, n_fields> makeSchema(std::index_sequence<Is...>)noexcept { return { fieldSchema<Field<Is>>()... }; }
+
+            template<size_t ... Is>
+            static constexpr size_t makeRecordBytes(std::index_sequence<Is...>)noexcept { return (sizeof(typename Field<Is>::ValueType) + ... + 0); }
+
+            static constexpr std::array<FieldSchema, n_fields> schema = makeSchema(std::make_index_sequence<n_fields>{});
+            static constexpr size_t record_bytes = makeRecordBytes(std::make_index_sequence<n_fields>{});
+        };
+    }
+
+    /// <summary>
+    /// Encodes records whose fields are Units, registered with CREATE_WIRE_RECORD, as packed little-endian values.
+    /// A stream starts with writeSchema(), which describes each field's dimensions, storage and conversion once;
+    /// records after it carry no per-field description at all.
+    /// </summary>
+    template<typename Record>
+    class RecordWriter
+    {
+    public:
+        using Layout = wire::RecordLayout<Record>;
+
+        static constexpr size_t recordBytes()noexcept { return Layout::record_bytes; }
+
+        //appends the schema header to out
+        void writeSchema(std::vector<std::byte>& out)const;
+
+        //appends the encoded records to out
+        void write(std::span<const Record> records, std::vector<std::byte>& out)const;
+
+    private:
+        template<size_t ... Is>
+        static void writeRecord(const Record& record, std::byte* dst, std::index_sequence<Is...>)noexcept;
+    };
+
+    /// <summary>
+    /// Decodes a stream written by RecordWriter into Records. The schema is checked against Record's fields once,
+    /// by readSchema(): every field must have the same dimensions, but may have been written with a different
+    /// conversion or NumericType, e.g. millimetres&lt;float&gt; into metres&lt;double&gt;. Fields that match exactly are
+    /// copied; the others are converted with one scale and offset found when the schema is read. When every field
+    /// matches and Record has no padding between them, whole runs of records are copied at once.
+    /// </summary>
+    template<typename Record>
+    class RecordReader
+    {
+    public:
+        using Layout = wire::RecordLayout<Record>;
+
+        //reads and validates the schema at the front of bytes, returning how many bytes it took, or 0 if bytes
+        //doesn't hold all of it yet. throws WireError if the schema doesn't match Record
+        size_t readSchema(std::span<const std::byte> bytes);
+
+        //appends every whole record in bytes to out, returning how many bytes were read
+        size_t read(std::span<const std::byte> bytes, std::vector<Record>& out)const;
+
+        bool hasSchema()const noexcept { return m_hasSchema; }
+        bool isBulk()const noexcept { return m_bulk; }
+        size_t recordBytes()const noexcept { return m_recordBytes; }
+
+    private:
+        struct Field
+        {
+            wire::FieldSchema schema;
+            size_t position = 0;
+            bool direct = false;
+            //takes a stored value to a value in the record's conversion
+            double scale = 1.0;
+            double offset = 0.0;
+        };
+
+        template<size_t ... Is>
+        void readRecord(const std::byte* src, Record& record, std::index_sequence<Is...>)const;
+
+        template<size_t I>
+        void readField(const std::byte* src, Record& record)const;
+
+        static bool hasPackedLayout()noexcept;
+
+        std::array<Field, Layout::n_fields> m_fields{};
+        size_t m_recordBytes = 0;
+        bool m_hasSchema = false;
+        bool m_bulk = false;
+    };
+
+    template<typename Record>
+    void RecordWriter<Record>::writeSchema(std::vector<std::byte>& out)const
+    {
+        const size_t start = out.size();
+        out.resize(start + wire::header_bytes + Layout::n_fields * wire::field_bytes);
+        std::byte* dst = out.data() + start;
+
+        std::memcpy(dst, wire::magic, sizeof(wire::magic));
+        wire::store<std::uint16_t>(dst + sizeof(wire::magic), static_cast<std::uint16_t>(Layout::n_fields));
+        dst += wire::header_bytes;
+
+        for (const wire::FieldSchema& f : Layout::schema)
+        {
+            for (size_t i = 0; i < n_standard_tags; ++i) dst[i] = static_cast<std::byte>(static_cast<std::int8_t>(f.signature.exponents[i]));
+            dst[n_standard_tags] = static_cast<std::byte>(f.kind);
+            dst[n_standard_tags + 1] = static_cast<std::byte>(f.size);
+            wire::store<double>(dst + n_standard_tags + 2, f.scale);
+            wire::store<double>(dst + n_standard_tags + 2 + sizeof(double), f.offset);
+            dst += wire::field_bytes;
+        }
+    }
+
+    template<typename Record>
+    void RecordWriter<Record>::write(std::span<const Record> records, std::vector<std::byte>& out)const
+    {
+        const size_t start = out.size();
+        out.resize(start + records.size() * Layout::record_bytes);
+        std::byte* dst = out.data() + start;
+        for (const Record& record : records)
+        {
+            writeRecord(record, dst, std::make_index_sequence<Layout::n_fields>{});
+            dst += Layout::record_bytes;
+        }
+    }
+
+    template<typename Record>
+    template<size_t ... Is>
+    void RecordWriter<Record>::writeRecord(const Record& record, std::byte* dst, std::index_sequence<Is...>)noexcept
+    {
+        size_t offset = 0;
+        ((wire::store(dst + offset, (record.*std::get<Is>(Layout::members)).value()),
+            offset += sizeof(typename Layout::template Field<Is>::ValueType)), ...);
+    }
+
+    template<typename Record>
+    bool RecordReader<Record>::hasPackedLayout()noexcept
+    {
+        if constexpr (!std::is_trivially_copyable_v<Record> || sizeof(Record) != Layout::record_bytes)
+        {
+            return false;
+        }
+        else
+        {
+            //the members must sit back to back in the order they were registered
+            const Record record{};
+            const auto* base = reinterpret_cast<const std::byte*>(&record);
+            size_t expected = 0;
+            bool packed = true;
+            auto check = [&](const auto& member)
+            {
+                packed = packed && reinterpret_cast<const std::byte*>(&member) - base == static_cast<std::ptrdiff_t>(expected);
+                expected += sizeof(member);
+            };
+            std::apply([&](auto... members) { (check(record.*members), ...); }, Layout::members);
+            return packed;
+        }
+    }
+
+    template<typename Record>
+    size_t RecordReader<Record>::readSchema(std::span<const std::byte> bytes)
+    {
+        if (bytes.size() < wire::header_bytes) return 0;
+        if (std::memcmp(bytes.data(), wire::magic, sizeof(wire::magic)) != 0) throw WireError("not a unit record stream");
+        const size_t n = wire::load<std::uint16_t>(bytes.data() + sizeof(wire::magic));
+        if (n != Layout::n_fields)
+        {
+            throw WireError("stream has " + std::to_string(n) + " fields, expected " + std::to_string(Layout::n_fields));
+        }
+        if (bytes.size() < wire::header_bytes + n * wire::field_bytes) return 0;
+
+        const std::byte* src = bytes.data() + wire::header_bytes;
+        size_t position = 0;
+        bool direct = true;
+        for (size_t f = 0; f < n; ++f, src += wire::field_bytes)
+        {
+            Field& field = m_fields[f];
+            for (size_t i = 0; i < n_standard_tags; ++i) field.schema.signature.exponents[i] = static_cast<std::int8_t>(src[i]);
+            field.schema.kind = static_cast<wire::Kind>(src[n_standard_tags]);
+            field.schema.size = static_cast<std::uint8_t>(src[n_standard_tags + 1]);
+            field.schema.scale = wire::load<double>(src + n_standard_tags + 2);
+            field.schema.offset = wire::load<double>(src + n_standard_tags + 2 + sizeof(double));
+
+            const wire::FieldSchema& local = Layout::schema[f];
+            if (field.schema.signature != local.signature) throw WireError("field " + std::to_string(f) + " has the wrong dimensions");
+            if (!wire::isSupported(field.schema.kind, field.schema.size))
+            {
+                throw WireError("field " + std::to_string(f) + " has an unsupported encoding");
+            }
+
+            //stored value -> standard -> local value, folded into one scale and offset
+            field.position = position;
+            field.direct = field.schema == local;
+            field.scale = field.schema.scale / local.scale;
+            field.offset = (field.schema.offset - local.offset) / local.scale;
+            direct = direct && field.direct;
+            position += field.schema.size;
+        }
+
+        m_recordBytes = position;
+        m_bulk = direct && std::endian::native == std::endian::little && hasPackedLayout();
+        m_hasSchema = true;
+        return wire::header_bytes + n * wire::field_bytes;
+    }
+
+    template<typename Record>
+    size_t RecordReader<Record>::read(std::span<const std::byte> bytes, std::vector<Record>& out)const
+    {
+        if (!m_hasSchema) throw WireError("records read before the schema");
+        const size_t n = bytes.size() / m_recordBytes;
+        const size_t start = out.size();
+        out.resize(start + n);
+
+        if (m_bulk)
+        {
+            std::memcpy(static_cast<void*>(out.data() + start), bytes.data(), n * m_recordBytes);
+        }
+        else
+        {
+            const std::byte* src = bytes.data();
+            for (size_t r = 0; r < n; ++r, src += m_recordBytes)
+            {
+                readRecord(src, out[start + r], std::make_index_sequence<Layout::n_fields>{});
+            }
+        }
+        return n * m_recordBytes;
+    }
+
+    template<typename Record>
+    template<size_t ... Is>
+    void RecordReader<Record>::readRecord(const std::byte* src, Record& record, std::index_sequence<Is...>)const
+    {
+        (readField<Is>(src, record), ...);
+    }
+
+    template<typename Record>
+    template<size_t I>
+    void RecordReader<Record>::readField(const std::byte* src, Record& record)const
+    {
+        using N = typename Layout::template Field<I>::ValueType;
+        const Field& field = m_fields[I];
+        N& value = (record.*std::get<I>(Layout::members)).value();
+
+        if (field.direct)
+        {
+            value = wire::load<N>(src + field.position);
+            return;
+        }
+
+        const double stored = field.schema.kind == Layout::schema[I].kind && field.schema.size == sizeof(N) ?
+            static_cast<double>(wire::load<N>(src + field.position)) : wire::loadAny(src + field.position, field.schema.kind, field.schema.size);
+        const double local = field.scale * stored + field.offset;
+        if constexpr (std::is_integral_v<N>) value = static_cast<N>(std::nearbyint(local));
+        else value = static_cast<N>(local);
+    }
+}
+
+//registers the Unit members of a record for RecordWriter and RecordReader, e.g.
+//CREATE_WIRE_RECORD(Reading, &Reading::position, &Reading::speed). use at global scope
+#define CREATE_WIRE_RECORD(record, ...)\
+template<>\
+struct units::wire::RecordFields<record>\
+{\
+    static constexpr auto members = std::make_tuple(__VA_ARGS__);\
+};
+
+#endif